@@ -0,0 +1,115 @@
+#include "core/DotProduct.h"
+#include "core/Timer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// rows of the same length with random columns of a dense vector, the
+// coefficients are stored in the three layouts of the sparse matrices
+struct SparseRows
+{
+   SparseRows(int nrows, int rowsize, int ncols) : size(rowsize)
+   {
+      std::mt19937 gen(0);
+      std::uniform_int_distribution<int> column(0, ncols - 1);
+      std::uniform_real_distribution<double> real(-10.0, 10.0);
+      std::uniform_int_distribution<int> code(0, 15);
+
+      int nnz = nrows * rowsize;
+      indices.resize(nnz);
+      values.resize(nnz);
+      floats.resize(nnz);
+      codes.resize(nnz);
+      for (int i = 0; i < nnz; ++i)
+      {
+         indices[i] = column(gen);
+         values[i] = real(gen);
+         floats[i] = static_cast<float>(real(gen));
+         codes[i] = static_cast<uint8_t>(code(gen));
+      }
+
+      dictionary.resize(16);
+      for (auto& value : dictionary)
+         value = real(gen);
+
+      x.resize(ncols);
+      for (auto& value : x)
+         value = real(gen);
+   }
+
+   int nrows() const { return indices.size() / size; }
+
+   VectorView row(int row, const char* storage) const
+   {
+      int start = row * size;
+      switch (storage[0])
+      {
+      case 'f':
+         return {CoefArray(floats.data() + start), indices.data() + start,
+                 size};
+      case 'c':
+         return {CoefArray(codes.data() + start, dictionary.data()),
+                 indices.data() + start, size};
+      default:
+         return {CoefArray(values.data() + start), indices.data() + start,
+                 size};
+      }
+   }
+
+   int size;
+   std::vector<int> indices;
+   std::vector<double> values;
+   std::vector<float> floats;
+   std::vector<uint8_t> codes;
+   std::vector<double> dictionary;
+   std::vector<double> x;
+};
+
+int
+main(int argc, char** argv)
+{
+   int nnz = argc > 1 ? std::atoi(argv[1]) : 1 << 22;
+   int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+   const int ncols = 1 << 16;
+
+   std::printf("runtime kernel %s\n", dotProductKernel());
+   std::printf("%-8s %6s %-8s %10s %s\n", "storage", "size", "kernel",
+               "ns/nnz", "checksum");
+
+   for (int rowsize : {4, 16, 64, 1024})
+   {
+      SparseRows rows(nnz / rowsize, rowsize, ncols);
+
+      for (const char* storage : {"double", "float", "coded"})
+      {
+         for (const char* kernel : {"scalar", "avx2", "avx512"})
+         {
+            if (!setDotProductKernel(kernel))
+               continue;
+
+            double checksum = 0.0;
+            auto t0 = Timer::now();
+            for (int round = 0; round < rounds; ++round)
+            {
+               for (int row = 0; row < rows.nrows(); ++row)
+                  checksum += dotProduct(rows.row(row, storage),
+                                         rows.x.data());
+            }
+            auto t1 = Timer::now();
+
+            double nanos =
+                1e9 * Timer::seconds(t1, t0) /
+                (static_cast<double>(rounds) * rows.nrows() * rowsize);
+
+            // the kernels round the same way, the checksums must be equal
+            std::printf("%-8s %6d %-8s %10.3f %.17g\n", storage, rowsize,
+                        kernel, nanos, checksum);
+         }
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,96 @@
+#include "core/Timer.h"
+#include "io/NumberParser.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// numbers as they appear in the COLUMNS and RHS sections: small
+// integers, decimals of various lengths and exponents
+static std::vector<std::string>
+makeFields(int nfields)
+{
+   std::mt19937 gen(0);
+   std::uniform_int_distribution<int> kind(0, 3);
+   std::uniform_int_distribution<int> integer(-100, 100);
+   std::uniform_real_distribution<double> real(-1e4, 1e4);
+   std::uniform_int_distribution<int> exponent(-30, 30);
+
+   std::vector<std::string> fields;
+   fields.reserve(nfields);
+
+   char buffer[32];
+   for (int i = 0; i < nfields; ++i)
+   {
+      switch (kind(gen))
+      {
+      case 0:
+         std::snprintf(buffer, sizeof(buffer), "%d", integer(gen));
+         break;
+      case 1:
+         std::snprintf(buffer, sizeof(buffer), "%.1f", real(gen));
+         break;
+      case 2:
+         std::snprintf(buffer, sizeof(buffer), "%.12g", real(gen));
+         break;
+      default:
+         std::snprintf(buffer, sizeof(buffer), "%.6e",
+                       real(gen) * std::pow(10.0, exponent(gen)));
+         break;
+      }
+      fields.emplace_back(buffer);
+   }
+
+   return fields;
+}
+
+template <typename PARSE>
+static double
+run(const char* name, const std::vector<std::string>& fields, int rounds,
+    PARSE parse)
+{
+   double checksum = 0.0;
+
+   auto t0 = Timer::now();
+   for (int round = 0; round < rounds; ++round)
+   {
+      for (const auto& field : fields)
+      {
+         double value;
+         if (!parse(std::string_view(field), value))
+         {
+            std::fprintf(stderr, "%s rejected %s\n", name, field.c_str());
+            std::exit(1);
+         }
+         checksum += value;
+      }
+   }
+   auto t1 = Timer::now();
+
+   double nanos = 1e9 * Timer::seconds(t1, t0) /
+                  (static_cast<double>(rounds) * fields.size());
+   std::printf("%-12s %8.2f ns/number  checksum %.17g\n", name, nanos,
+               checksum);
+
+   return nanos;
+}
+
+int
+main(int argc, char** argv)
+{
+   int nfields = argc > 1 ? std::atoi(argv[1]) : 1000000;
+   int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+   auto fields = makeFields(nfields);
+
+   double strtod_ns = run("strtod", fields, rounds, parseDoubleStrtod);
+   double parse_ns = run("parseDouble", fields, rounds, parseDouble);
+
+   std::printf("speedup %.2fx\n", strtod_ns / parse_ns);
+
+   return 0;
+}
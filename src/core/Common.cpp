@@ -1,52 +1,131 @@
 #include "Common.h"
+#include "DotProduct.h"
 #include "Numerics.h"
 #include "SparseMatrix.h"
 
-std::vector<Activity>
-computeActivities(const MIP& mip)
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+// tall matrices are swept in parallel blocks of rows with about
+// parallel_block_nnz nonzeros
+static constexpr int parallel_block_nnz = 1 << 15;
+
+static int
+rowGrain(const Statistics& st)
 {
-   int nrows = mip.getNRows();
-   std::vector<Activity> activities(nrows);
+   return std::max(64, static_cast<int>(static_cast<int64_t>(st.nrows) *
+                                        parallel_block_nnz / st.nnzmat));
+}
 
-   const auto& lb = mip.getLB();
-   const auto& ub = mip.getUB();
+Activity
+computeActivity(const MIP& mip, int row, const std::vector<double>& lb,
+                const std::vector<double>& ub)
+{
+   Activity activity;
 
-   for (int row = 0; row < nrows; ++row)
+   auto [coefs, indices, rowsize] = mip.getRow(row);
+
+   for (int colid = 0; colid < rowsize; ++colid)
    {
-      auto [coefs, indices, rowsize] = mip.getRow(row);
+      const double coef = coefs[colid];
+      const int col = indices[colid];
 
-      for (int colid = 0; colid < rowsize; ++colid)
+      if (coef > 0.0)
       {
-         const double coef = coefs[colid];
-         const int col = indices[colid];
+         if (!Num::isMinusInf(lb[col]))
+            activity.min += lb[col] * coef;
+         else
+            activity.ninfmin++;
 
-         if (coef > 0.0)
-         {
-            if (!Num::isMinusInf(lb[col]))
-               activities[row].min += lb[col] * coef;
-            else
-               activities[row].ninfmin++;
+         if (!Num::isInf(ub[col]))
+            activity.max += ub[col] * coef;
+         else
+            activity.ninfmax++;
+      }
+      else
+      {
+         if (!Num::isMinusInf(lb[col]))
+            activity.max += lb[col] * coef;
+         else
+            ++activity.ninfmax;
 
-            if (!Num::isInf(ub[col]))
-               activities[row].max += ub[col] * coef;
-            else
-               activities[row].ninfmax++;
-         }
+         if (!Num::isInf(ub[col]))
+            activity.min += ub[col] * coef;
          else
-         {
-            if (!Num::isMinusInf(lb[col]))
-               activities[row].max += lb[col] * coef;
-            else
-               ++activities[row].ninfmax;
+            activity.ninfmin++;
+      }
+   }
 
-            if (!Num::isInf(ub[col]))
-               activities[row].min += ub[col] * coef;
-            else
-               activities[row].ninfmin++;
-         }
+   return activity;
+}
+
+// row i of the matrix is in block k if blocks[k] <= i < blocks[k + 1], the
+// blocks have about parallel_block_nnz nonzeros whatever the row lengths
+static std::vector<int>
+rowBlocks(const MIP& mip)
+{
+   int nrows = mip.getNRows();
+
+   std::vector<int> blocks{0};
+   blocks.reserve(mip.getStats().nnzmat / parallel_block_nnz + 2);
+
+   int64_t blocknnz = 0;
+   for (int row = 0; row < nrows; ++row)
+   {
+      blocknnz += mip.getRowSize(row);
+      if (blocknnz >= parallel_block_nnz)
+      {
+         blocks.push_back(row + 1);
+         blocknnz = 0;
       }
    }
 
+   if (blocks.back() != nrows)
+      blocks.push_back(nrows);
+
+   return blocks;
+}
+
+// calls compute(first, last) on ranges of rows, in parallel blocks of
+// rows for large matrices. Each row is computed by a single call so the
+// results do not depend on the partition.
+template <typename COMPUTE>
+static void
+forRowBlocks(const MIP& mip, COMPUTE&& compute)
+{
+   if (mip.getStats().nnzmat < 4 * parallel_block_nnz)
+   {
+      compute(0, mip.getNRows());
+      return;
+   }
+
+   auto blocks = rowBlocks(mip);
+
+   tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks.size() - 1, 1),
+                     [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t k = range.begin(); k < range.end(); ++k)
+                           compute(blocks[k], blocks[k + 1]);
+                     });
+}
+
+std::vector<Activity>
+computeActivities(const MIP& mip)
+{
+   std::vector<Activity> activities(mip.getNRows());
+
+   const auto& lb = mip.getLB();
+   const auto& ub = mip.getUB();
+
+   forRowBlocks(mip, [&](int first, int last) {
+      for (int row = first; row < last; ++row)
+         activities[row] = computeActivity(mip, row, lb, ub);
+   });
+
    return activities;
 }
 
@@ -55,22 +134,91 @@ computeSolActivities(const MIP& mip, const std::vector<double>& sol)
 {
    int nrows = mip.getNRows();
 
-   std::vector<double> activities(nrows, 0.0);
+   std::vector<double> activities(nrows);
 
-   for (int row = 0; row < nrows; ++row)
+   forRowBlocks(mip, [&](int first, int last) {
+      rowActivities(mip, first, last, sol.data(), activities.data());
+   });
+
+   return activities;
+}
+
+SolutionReport
+evaluateSolution(const MIP& mip, const std::vector<double>& sol,
+                 bool integral, bool earlyExit, double boundtol,
+                 double constol)
+{
+   const auto& ub = mip.getUB();
+   const auto& lb = mip.getLB();
+   const auto& lhs = mip.getLHS();
+   const auto& rhs = mip.getRHS();
+   const auto& obj = mip.getObj();
+   auto st = mip.getStats();
+
+   assert(sol.size() == static_cast<size_t>(st.ncols));
+
+   SolutionReport report;
+
+   // bounds, integrality and objective
+   for (int col = 0; col < st.ncols; ++col)
    {
-      auto [coefs, indices, rowsize] = mip.getRow(row);
+      report.objective += obj[col] * sol[col];
+
+      if (sol[col] > ub[col] + boundtol)
+         report.addViolation(sol[col] - ub[col]);
+      else if (sol[col] < lb[col] - boundtol)
+         report.addViolation(lb[col] - sol[col]);
+
+      if (integral && col < st.nbin + st.nint &&
+          !Num::isFeasInt(sol[col]))
+         report.addViolation(std::fabs(sol[col] - Num::round(sol[col])));
 
-      for (int colid = 0; colid < rowsize; ++colid)
+      if (earlyExit && !report.feasible)
+         return report;
+   }
+
+   // rows, the blocks stop as soon as one of them found a violation
+   std::atomic<bool> stop{false};
+
+   auto evaluateRows = [&](const tbb::blocked_range<int>& range,
+                           SolutionReport partial) {
+      for (int row = range.begin(); row != range.end(); ++row)
       {
-         const double coef = coefs[colid];
-         const int col = indices[colid];
+         if (earlyExit && stop.load(std::memory_order_relaxed))
+            break;
+
+         double activity = dotProduct(mip.getRow(row), sol.data());
+
+         if (activity > rhs[row] + constol)
+            partial.addViolation(activity - rhs[row]);
+         else if (activity < lhs[row] - constol)
+            partial.addViolation(lhs[row] - activity);
 
-         activities[row] += sol[col] * coef;
+         if (earlyExit && !partial.feasible)
+         {
+            stop.store(true, std::memory_order_relaxed);
+            break;
+         }
       }
-   }
 
-   return activities;
+      return partial;
+   };
+
+   if (st.nnzmat < 4 * parallel_block_nnz)
+      return evaluateRows(tbb::blocked_range<int>(0, st.nrows), report);
+
+   auto merge = [](SolutionReport left, const SolutionReport& right) {
+      left.feasible = left.feasible && right.feasible;
+      left.nviolated += right.nviolated;
+      left.maxviolation = std::max(left.maxviolation, right.maxviolation);
+      left.objective += right.objective;
+      return left;
+   };
+
+   return merge(report, tbb::parallel_reduce(
+                            tbb::blocked_range<int>(0, st.nrows,
+                                                    rowGrain(st)),
+                            SolutionReport(), evaluateRows, merge));
 }
 
 // TODO use hashset
@@ -249,22 +397,15 @@ maxOutSolution(const MIP& mip, std::vector<double>& solution, double& cost)
    const auto& ub = mip.getUB();
    const auto& objective = mip.getObj();
 
-   std::vector<double> activities(st.nrows, 0.0);
+   std::vector<double> activities = computeSolActivities(mip, solution);
 
+#ifndef NDEBUG
    for (int row = 0; row < st.nrows; ++row)
    {
-      auto [rowcoefs, rowindices, rowsize] = mip.getRow(row);
-
-      for (int i = 0; i < rowsize; ++i)
-      {
-         int col = rowindices[i];
-         double coef = rowcoefs[i];
-         activities[row] += coef * solution[col];
-      }
-
       assert(Num::isFeasGE(activities[row], lhs[row]));
       assert(Num::isFeasLE(activities[row], rhs[row]));
    }
+#endif
 
    for (int col = 0; col < st.ncols; ++col)
    {
@@ -1,10 +1,12 @@
 #ifndef _COMMON_HPP_
 #define _COMMON_HPP_
 
+#include "DotProduct.h"
 #include "MIP.h"
 #include "Numerics.h"
 #include "SparseMatrix.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <memory>
@@ -26,6 +28,11 @@ struct Activity
 std::vector<Activity>
 computeActivities(const MIP& mip);
 
+// get the activity of a row under the given bounds
+Activity
+computeActivity(const MIP& mip, int row, const std::vector<double>& lb,
+                const std::vector<double>& ub);
+
 // get the solution activities
 std::vector<double>
 computeSolActivities(const MIP& mip, const std::vector<double>& sol);
@@ -41,46 +48,40 @@ std::vector<int>
 getFractional(const std::vector<double>&, int ninteger);
 
 
-template <typename REAL, bool LP = false>
-bool
-checkFeasibility(const MIP& mip, const std::vector<double>& sol,
-                 REAL boundtol = 1e-9, REAL constol = 1e-6)
+// result of the evaluation of a solution
+struct SolutionReport
 {
-   const auto& ub = mip.getUB();
-   const auto& lb = mip.getLB();
-   const auto& lhs = mip.getLHS();
-   const auto& rhs = mip.getRHS();
-   auto st = mip.getStats();
-
-   assert(sol.size() == static_cast<size_t>(mip.getNCols()));
-
-   for (int colid = 0; colid < mip.getNCols(); ++colid)
+   void addViolation(double violation)
    {
-      if (sol[colid] > ub[colid] + boundtol ||
-          sol[colid] < lb[colid] - boundtol)
-         return false;
-
-      if constexpr (!LP)
-      {
-         if (colid < st.nbin + st.nint && !Num::isFeasInt(sol[colid]))
-            return false;
-      }
+      feasible = false;
+      ++nviolated;
+      maxviolation = std::max(maxviolation, violation);
    }
 
-   for (int rowid = 0; rowid < mip.getNRows(); ++rowid)
-   {
-      auto [coefs, indices, size] = mip.getRow(rowid);
-      REAL activity{0.0};
+   bool feasible = true;
+   // violated bounds, integralities and rows
+   int nviolated = 0;
+   // largest violation of a bound, integrality or row
+   double maxviolation = 0.0;
+   double objective = 0.0;
+};
 
-      for (int id = 0; id < size; ++id)
-         activity += coefs[id] * sol[indices[id]];
+// checks bounds, integrality (if integral) and rows in one sweep over the
+// matrix, large matrices are checked in parallel blocks of rows
+// with earlyExit the sweep stops at the first violation, the counts and
+// the objective are then incomplete
+SolutionReport
+evaluateSolution(const MIP& mip, const std::vector<double>& sol,
+                 bool integral = true, bool earlyExit = false,
+                 double boundtol = 1e-9, double constol = 1e-6);
 
-      if (activity > rhs[rowid] + constol ||
-          activity < lhs[rowid] - constol)
-         return false;
-   }
-
-   return true;
+template <typename REAL, bool LP = false>
+bool
+checkFeasibility(const MIP& mip, const std::vector<double>& sol,
+                 REAL boundtol = 1e-9, REAL constol = 1e-6)
+{
+   return evaluateSolution(mip, sol, !LP, true, boundtol, constol)
+       .feasible;
 }
 
 template <typename REAL, bool LP = false>
@@ -88,42 +89,8 @@ int
 getNViolated(const MIP& mip, const std::vector<double>& sol,
              REAL boundtol = 1e-9, REAL constol = 1e-6)
 {
-   const auto& ub = mip.getUB();
-   const auto& lb = mip.getLB();
-   const auto& lhs = mip.getLHS();
-   const auto& rhs = mip.getRHS();
-   auto st = mip.getStats();
-
-   assert(sol.size() == static_cast<size_t>(mip.getNCols()));
-
-   int ninfeas = 0;
-   for (int colid = 0; colid < mip.getNCols(); ++colid)
-   {
-      if (sol[colid] > ub[colid] + boundtol ||
-          sol[colid] < lb[colid] - boundtol)
-         ++ninfeas;
-
-      if constexpr (!LP)
-      {
-         if (colid < st.nbin + st.nint && !Num::isFeasInt(sol[colid]))
-            ++ninfeas;
-      }
-   }
-
-   for (int rowid = 0; rowid < mip.getNRows(); ++rowid)
-   {
-      auto [coefs, indices, size] = mip.getRow(rowid);
-      REAL activity{0.0};
-
-      for (int id = 0; id < size; ++id)
-         activity += coefs[id] * sol[indices[id]];
-
-      if (activity > rhs[rowid] + constol ||
-          activity < lhs[rowid] - constol)
-         ++ninfeas;
-   }
-
-   return ninfeas;
+   return evaluateSolution(mip, sol, !LP, false, boundtol, constol)
+       .nviolated;
 }
 
 // reorders the rows of a sparse matrix
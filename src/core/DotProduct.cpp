@@ -0,0 +1,357 @@
+#include "DotProduct.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GPH_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// access to the coefficients of each storage
+struct DoubleCoefs
+{
+   explicit DoubleCoefs(const CoefArray& coefs) : values(coefs.values) {}
+
+   double operator[](int i) const { return values[i]; }
+
+   const double* values;
+};
+
+struct FloatCoefs
+{
+   explicit FloatCoefs(const CoefArray& coefs) : floats(coefs.floats) {}
+
+   double operator[](int i) const { return floats[i]; }
+
+   const float* floats;
+};
+
+struct CodedCoefs
+{
+   explicit CodedCoefs(const CoefArray& coefs)
+       : codes(coefs.codes), dictionary(coefs.dictionary)
+   {
+   }
+
+   double operator[](int i) const { return dictionary[codes[i]]; }
+
+   const uint8_t* codes;
+   const double* dictionary;
+};
+
+template <typename COEFS>
+static double
+dotScalar(COEFS coefs, const int* indices, int size, const double* x)
+{
+   double sums[4] = {0.0, 0.0, 0.0, 0.0};
+
+   int i = 0;
+   for (; i + 4 <= size; i += 4)
+   {
+      for (int j = 0; j < 4; ++j)
+         sums[j] += coefs[i + j] * x[indices[i + j]];
+   }
+
+   double sum = (sums[0] + sums[2]) + (sums[1] + sums[3]);
+   for (; i < size; ++i)
+      sum += coefs[i] * x[indices[i]];
+
+   return sum;
+}
+
+#ifdef GPH_X86_KERNELS
+
+// products are added without fma to round like the scalar kernel
+
+__attribute__((target("avx2"))) static __m256d
+load4(DoubleCoefs coefs, int i)
+{
+   return _mm256_loadu_pd(coefs.values + i);
+}
+
+__attribute__((target("avx2"))) static __m256d
+load4(FloatCoefs coefs, int i)
+{
+   return _mm256_cvtps_pd(_mm_loadu_ps(coefs.floats + i));
+}
+
+__attribute__((target("avx2"))) static __m256d
+load4(CodedCoefs coefs, int i)
+{
+   int32_t packed;
+   std::memcpy(&packed, coefs.codes + i, sizeof(packed));
+   __m128i codes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+
+   return _mm256_i32gather_pd(coefs.dictionary, codes, 8);
+}
+
+template <typename COEFS>
+__attribute__((target("avx2"))) static double
+dotAvx2(COEFS coefs, const int* indices, int size, const double* x)
+{
+   __m256d sums = _mm256_setzero_pd();
+
+   int i = 0;
+   for (; i + 4 <= size; i += 4)
+   {
+      __m128i idx = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(indices + i));
+      __m256d values = _mm256_i32gather_pd(x, idx, 8);
+      sums = _mm256_add_pd(sums, _mm256_mul_pd(load4(coefs, i), values));
+   }
+
+   // (s0 + s2) + (s1 + s3)
+   __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sums),
+                             _mm256_extractf128_pd(sums, 1));
+   double sum = _mm_cvtsd_f64(half) +
+                _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+
+   for (; i < size; ++i)
+      sum += coefs[i] * x[indices[i]];
+
+   return sum;
+}
+
+__attribute__((target("avx512f"))) static __m512d
+load8(DoubleCoefs coefs, int i)
+{
+   return _mm512_loadu_pd(coefs.values + i);
+}
+
+__attribute__((target("avx512f"))) static __m512d
+load8(FloatCoefs coefs, int i)
+{
+   return _mm512_cvtps_pd(_mm256_loadu_ps(coefs.floats + i));
+}
+
+__attribute__((target("avx512f"))) static __m512d
+load8(CodedCoefs coefs, int i)
+{
+   __m128i packed = _mm_loadl_epi64(
+       reinterpret_cast<const __m128i*>(coefs.codes + i));
+
+   return _mm512_i32gather_pd(_mm256_cvtepu8_epi32(packed),
+                              coefs.dictionary, 8);
+}
+
+// eight products per step, added as two steps of four to keep the order
+template <typename COEFS>
+__attribute__((target("avx512f"))) static double
+dotAvx512(COEFS coefs, const int* indices, int size, const double* x)
+{
+   __m256d sums = _mm256_setzero_pd();
+
+   int i = 0;
+   for (; i + 8 <= size; i += 8)
+   {
+      __m256i idx = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(indices + i));
+      __m512d products =
+          _mm512_mul_pd(load8(coefs, i), _mm512_i32gather_pd(idx, x, 8));
+
+      sums = _mm256_add_pd(sums, _mm512_castpd512_pd256(products));
+      sums = _mm256_add_pd(sums, _mm512_extractf64x4_pd(products, 1));
+   }
+
+   if (i + 4 <= size)
+   {
+      __m128i idx = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(indices + i));
+      __m256d values = _mm256_i32gather_pd(x, idx, 8);
+      sums = _mm256_add_pd(sums, _mm256_mul_pd(load4(coefs, i), values));
+      i += 4;
+   }
+
+   __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sums),
+                             _mm256_extractf128_pd(sums, 1));
+   double sum = _mm_cvtsd_f64(half) +
+                _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+
+   for (; i < size; ++i)
+      sum += coefs[i] * x[indices[i]];
+
+   return sum;
+}
+
+#endif
+
+// the row loops are compiled for each kernel so the dot products are
+// inlined and the dispatch is done once per call
+
+template <typename COEFS>
+static void
+rowsScalar(const MIP& mip, int first, int last, const double* x,
+           double* activities)
+{
+   for (int row = first; row < last; ++row)
+   {
+      VectorView view = mip.getRow(row);
+      activities[row] =
+          dotScalar(COEFS(view.coefs), view.indices, view.size, x);
+   }
+}
+
+#ifdef GPH_X86_KERNELS
+
+template <typename COEFS>
+__attribute__((target("avx2"))) static void
+rowsAvx2(const MIP& mip, int first, int last, const double* x,
+         double* activities)
+{
+   for (int row = first; row < last; ++row)
+   {
+      VectorView view = mip.getRow(row);
+      activities[row] =
+          dotAvx2(COEFS(view.coefs), view.indices, view.size, x);
+   }
+}
+
+template <typename COEFS>
+__attribute__((target("avx512f"))) static void
+rowsAvx512(const MIP& mip, int first, int last, const double* x,
+           double* activities)
+{
+   for (int row = first; row < last; ++row)
+   {
+      VectorView view = mip.getRow(row);
+      activities[row] =
+          dotAvx512(COEFS(view.coefs), view.indices, view.size, x);
+   }
+}
+
+#endif
+
+enum Kernel
+{
+   SCALAR,
+   AVX2,
+   AVX512,
+};
+
+static Kernel
+detectKernel()
+{
+#ifdef GPH_X86_KERNELS
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx512f"))
+      return AVX512;
+   if (__builtin_cpu_supports("avx2"))
+      return AVX2;
+#endif
+   return SCALAR;
+}
+
+static Kernel kernel = detectKernel();
+
+template <typename COEFS>
+static double
+dot(COEFS coefs, const int* indices, int size, const double* x)
+{
+#ifdef GPH_X86_KERNELS
+   switch (kernel)
+   {
+   case AVX512:
+      return dotAvx512(coefs, indices, size, x);
+   case AVX2:
+      return dotAvx2(coefs, indices, size, x);
+   case SCALAR:
+      break;
+   }
+#endif
+   return dotScalar(coefs, indices, size, x);
+}
+
+template <typename COEFS>
+static void
+rows(const MIP& mip, int first, int last, const double* x,
+     double* activities)
+{
+#ifdef GPH_X86_KERNELS
+   switch (kernel)
+   {
+   case AVX512:
+      rowsAvx512<COEFS>(mip, first, last, x, activities);
+      return;
+   case AVX2:
+      rowsAvx2<COEFS>(mip, first, last, x, activities);
+      return;
+   case SCALAR:
+      break;
+   }
+#endif
+   rowsScalar<COEFS>(mip, first, last, x, activities);
+}
+
+double
+dotProduct(VectorView view, const double* x)
+{
+   const CoefArray& coefs = view.coefs;
+
+   if (coefs.codes)
+      return dot(CodedCoefs(coefs), view.indices, view.size, x);
+   if (coefs.floats)
+      return dot(FloatCoefs(coefs), view.indices, view.size, x);
+
+   return dot(DoubleCoefs(coefs), view.indices, view.size, x);
+}
+
+void
+rowActivities(const MIP& mip, int first, int last, const double* x,
+              double* activities)
+{
+   if (first >= last)
+      return;
+
+   // all the rows use the same storage
+   const CoefArray coefs = mip.getRow(first).coefs;
+
+   if (coefs.codes)
+      rows<CodedCoefs>(mip, first, last, x, activities);
+   else if (coefs.floats)
+      rows<FloatCoefs>(mip, first, last, x, activities);
+   else
+      rows<DoubleCoefs>(mip, first, last, x, activities);
+}
+
+const char*
+dotProductKernel()
+{
+   switch (kernel)
+   {
+   case AVX512:
+      return "avx512";
+   case AVX2:
+      return "avx2";
+   case SCALAR:
+      break;
+   }
+
+   return "scalar";
+}
+
+bool
+setDotProductKernel(std::string_view name)
+{
+   if (name == "scalar")
+   {
+      kernel = SCALAR;
+      return true;
+   }
+
+#ifdef GPH_X86_KERNELS
+   __builtin_cpu_init();
+   if (name == "avx2" && __builtin_cpu_supports("avx2"))
+   {
+      kernel = AVX2;
+      return true;
+   }
+   if (name == "avx512" && __builtin_cpu_supports("avx512f"))
+   {
+      kernel = AVX512;
+      return true;
+   }
+#endif
+
+   return false;
+}
@@ -0,0 +1,33 @@
+#ifndef DOTPRODUCT_HPP
+#define DOTPRODUCT_HPP
+
+#include "MIP.h"
+
+#include <string_view>
+
+// sparse-dense dot products used to compute row activities
+// the vector instructions are picked at runtime (avx512, avx2 or
+// scalar), all kernels sum the entries in the same order so the results
+// do not depend on the machine: four partial sums where sum j takes the
+// entries j, j + 4, ..., combined as (s0 + s2) + (s1 + s3), followed by
+// the remaining entries one by one
+
+double
+dotProduct(VectorView view, const double* x);
+
+// activities of the rows in [first, last)
+void
+rowActivities(const MIP& mip, int first, int last, const double* x,
+              double* activities);
+
+// name of the kernel picked at runtime
+const char*
+dotProductKernel();
+
+// replaces the kernel picked at runtime by the one with the given name,
+// returns false if the machine does not support it, only for benchmarks
+// since it is not thread safe
+bool
+setDotProductKernel(std::string_view name);
+
+#endif
@@ -9,9 +9,22 @@
 
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <functional>
 #include <mutex>
+#include <numeric>
+
+// true if the solution is optimal up to a relative gap of 0.1%
+static bool
+isGapClosed(double cost, double dualbound)
+{
+   return (cost - dualbound) / (std::fabs(dualbound) + 1e-6) < 1e-3;
+}
 
 Search::Search(std::initializer_list<FeasibilityHeuristic*> feas_heur_list,
                std::initializer_list<ImprovementHeuristic*> impr_heur_list,
@@ -32,13 +45,46 @@ Search::Search(std::initializer_list<FeasibilityHeuristic*> feas_heur_list,
    }
 
    feas_solutions_pools.resize(feas_heuristics.size());
+   feas_stats.resize(feas_heuristics.size());
    impr_solutions_pools.resize(impr_heuristics.size());
+   impr_running.resize(impr_heuristics.size(), false);
+
+   for (auto& pool : feas_solutions_pools)
+      pool.setGlobal(&global_pool);
+   for (auto& pool : impr_solutions_pools)
+      pool.setGlobal(&global_pool);
 
    // pass configuration to heuristics
    try
    {
       for (auto [heur_name, param_name, value] : config)
       {
+         // Search/pool_capacity = maximum number of solutions kept by
+         // each heuristic
+         if (heur_name == "Search" && param_name == "pool_capacity")
+         {
+            int capacity = std::get<int>(value);
+            if (capacity <= 0)
+               throw std::runtime_error("pool_capacity must be positive");
+
+            for (auto& pool : feas_solutions_pools)
+               pool.setCapacity(capacity);
+            for (auto& pool : impr_solutions_pools)
+               pool.setCapacity(capacity);
+            continue;
+         }
+
+         // Search/portfolio_rounds = number of times the successful
+         // feasibility heuristics are run again
+         if (heur_name == "Search" && param_name == "portfolio_rounds")
+         {
+            portfolio_rounds = std::get<int>(value);
+            if (portfolio_rounds < 0)
+               throw std::runtime_error(
+                   "portfolio_rounds must be nonnegative");
+            continue;
+         }
+
          auto iter = feas_heur_name_to_id.find(heur_name);
          if (iter != feas_heur_name_to_id.end())
          {
@@ -66,56 +112,48 @@ Search::Search(std::initializer_list<FeasibilityHeuristic*> feas_heur_list,
    }
 }
 
-std::tuple<int, int, double, int>
+std::tuple<int, double, int>
 Search::getFeasSolSummary() const
 {
    int feas_min_cost_heur = -1;
-   int feas_min_cost_sol = -1;
    double min_cost = std::numeric_limits<double>::max();
    int nsols = 0;
 
    for (size_t i = 0; i < feas_solutions_pools.size(); ++i)
    {
-      nsols += feas_solutions_pools[i].size();
+      nsols += feas_solutions_pools[i].getNFound();
 
-      for (size_t j = 0; j < feas_solutions_pools[i].size(); ++j)
+      if (!feas_solutions_pools[i].empty() &&
+          feas_solutions_pools[i].best().second < min_cost)
       {
-         if (feas_solutions_pools[i][j].second < min_cost)
-         {
-            min_cost = feas_solutions_pools[i][j].second;
-            feas_min_cost_heur = i;
-            feas_min_cost_sol = j;
-         }
+         min_cost = feas_solutions_pools[i].best().second;
+         feas_min_cost_heur = i;
       }
    }
 
-   return {feas_min_cost_heur, feas_min_cost_sol, min_cost, nsols};
+   return {feas_min_cost_heur, min_cost, nsols};
 }
 
-std::tuple<int, int, double, int>
+std::tuple<int, double, int>
 Search::getImprSolSummary() const
 {
    int impr_min_cost_heur = -1;
-   int impr_min_cost_sol = -1;
    double min_cost = std::numeric_limits<double>::max();
    int nsols = 0;
 
    for (size_t i = 0; i < impr_solutions_pools.size(); ++i)
    {
-      nsols += impr_solutions_pools[i].size();
+      nsols += impr_solutions_pools[i].getNFound();
 
-      for (size_t j = 0; j < impr_solutions_pools[i].size(); ++j)
+      if (!impr_solutions_pools[i].empty() &&
+          impr_solutions_pools[i].best().second < min_cost)
       {
-         if (impr_solutions_pools[i][j].second < min_cost)
-         {
-            min_cost = impr_solutions_pools[i][j].second;
-            impr_min_cost_heur = i;
-            impr_min_cost_sol = j;
-         }
+         min_cost = impr_solutions_pools[i].best().second;
+         impr_min_cost_heur = i;
       }
    }
 
-   return {impr_min_cost_heur, impr_min_cost_sol, min_cost, nsols};
+   return {impr_min_cost_heur, min_cost, nsols};
 }
 
 bool
@@ -123,13 +161,12 @@ Search::checkSolFeas(const MIP& mip) const
 {
    for (size_t i = 0; i < feas_solutions_pools.size(); ++i)
    {
-      for (size_t j = 0; j < feas_solutions_pools[i].size(); ++j)
+      for (const auto& [key, solution] : feas_solutions_pools[i])
       {
-         if (!checkFeasibility(mip, feas_solutions_pools[i][j].first, 1e-9,
-                               1e-6))
+         if (!checkFeasibility(mip, solution.first, 1e-9, 1e-6))
          {
-            Message::debug("{} solution number {} is INFEASIBLE",
-                           feas_heuristics[i]->getName(), j);
+            Message::debug("{} solution with objective {} is INFEASIBLE",
+                           feas_heuristics[i]->getName(), key.first);
             return false;
          }
       }
@@ -137,7 +174,51 @@ Search::checkSolFeas(const MIP& mip) const
    return true;
 }
 
-std::tuple<int, int, double>
+std::vector<size_t>
+Search::selectFeasHeuristics() const
+{
+   // ucb index on the reward per second of runtime, the heuristics that
+   // never found a solution are not run again
+   int nruns = 0;
+   double maxrate = 0.0;
+   std::vector<double> rates(feas_heuristics.size());
+
+   for (size_t i = 0; i < feas_heuristics.size(); ++i)
+   {
+      nruns += feas_stats[i].nruns;
+      rates[i] = feas_stats[i].reward /
+                 (feas_heuristics[i]->getRunTime() + min_runtime);
+      maxrate = std::max(maxrate, rates[i]);
+   }
+
+   std::vector<std::pair<double, size_t>> indices;
+   for (size_t i = 0; i < feas_heuristics.size(); ++i)
+   {
+      if (feas_stats[i].reward == 0.0)
+         continue;
+
+      double bonus = maxrate * std::sqrt(2.0 * std::log(nruns) /
+                                         feas_stats[i].nruns);
+      indices.emplace_back(rates[i] + bonus, i);
+   }
+
+   // one run per thread and at most one run of each heuristic, they are
+   // not reentrant
+   size_t nslots = std::min(
+       indices.size(),
+       static_cast<size_t>(tbb::this_task_arena::max_concurrency()));
+
+   std::partial_sort(indices.begin(), indices.begin() + nslots,
+                     indices.end(), std::greater<>());
+
+   std::vector<size_t> selected(nslots);
+   for (size_t k = 0; k < nslots; ++k)
+      selected[k] = indices[k].second;
+
+   return selected;
+}
+
+std::pair<int, double>
 Search::run_feas_search(const MIP& mip, TimeLimit tlimit,
                         std::shared_ptr<LPSolver> lpSolver,
                         const std::vector<Activity>& activities)
@@ -149,14 +230,15 @@ Search::run_feas_search(const MIP& mip, TimeLimit tlimit,
 
    Message::print("Solving root LP:");
    auto t0 = Timer::now();
-   result = lpSolver->solve(Algorithm::DUAL);
+   TimeLimit lplimit(t0, limits.rootlp, tlimit.getToken());
+   result = lpSolver->solve(Algorithm::DUAL, lplimit.getToken());
    auto t1 = Timer::now();
 
    if (result.status != LPResult::OPTIMAL)
    {
       Message::print("The LP solver returned with status {}",
                      to_str(result.status));
-      return {-1, -1, 0.0};
+      return {-1, 0.0};
    }
 
 #ifndef NDEBUG
@@ -180,40 +262,89 @@ Search::run_feas_search(const MIP& mip, TimeLimit tlimit,
                   fractional.size(), percfrac);
    Message::print("");
 
-   auto run_feas = [&](tbb::blocked_range<size_t>& range) -> void {
-      for (size_t i = range.begin(); i != range.end(); ++i)
-         feas_heuristics[i]->execute(
-             mip, mip.getLB(), mip.getUB(), activities, result, lpSolAct,
-             fractional, lpSolver, tlimit, feas_solutions_pools[i]);
+   // every new incumbent starts the improvement heuristics right away,
+   // they run alongside the feasibility heuristics
+   double dualbound = result.obj;
+   global_pool.setListener([&, tlimit, lpSolver, dualbound]() {
+      start_impr_search(mip, tlimit, lpSolver, activities, dualbound);
+   });
+
+   TimeLimit feaslimit(Timer::now(), limits.feasibility,
+                       tlimit.getToken());
+
+   // runs a heuristic and rewards it with 0.5 for a new solution and 0.5
+   // for a new incumbent
+   auto run_feas = [&](size_t i) -> double {
+      auto& pool = feas_solutions_pools[i];
+      size_t nfound = pool.getNFound();
+      double cutoff = global_pool.getCutoff();
+
+      feas_heuristics[i]->execute(mip, mip.getLB(), mip.getUB(),
+                                  activities, result, lpSolAct, fractional,
+                                  lpSolver, feaslimit, pool);
+
+      double reward = 0.0;
+      if (pool.getNFound() > nfound)
+         reward += 0.5;
+      if (!pool.empty() && pool.best().second < cutoff)
+         reward += 0.5;
+
+      feas_stats[i].nruns += 1;
+      feas_stats[i].reward += reward;
+      return reward;
    };
 
    Message::print("Running feasibility heuristics:");
-   tbb::parallel_for(tbb::blocked_range<size_t>{0, feas_heuristics.size()},
-                     std::move(run_feas));
+
+   // every heuristic runs once, then the most successful ones run again
+   std::vector<size_t> selected(feas_heuristics.size());
+   std::iota(selected.begin(), selected.end(), 0);
+
+   for (int round = 0; round <= portfolio_rounds; ++round)
+   {
+      double reward = tbb::parallel_reduce(
+          tbb::blocked_range<size_t>(0, selected.size(), 1), 0.0,
+          [&](const tbb::blocked_range<size_t>& range, double sum) {
+             for (size_t k = range.begin(); k != range.end(); ++k)
+                sum += run_feas(selected[k]);
+             return sum;
+          },
+          std::plus<double>());
+
+      // the heuristics do not find anything new anymore
+      if (reward == 0.0 || feaslimit.reached() ||
+          (global_pool.hasSolution() &&
+           isGapClosed(global_pool.getCutoff(), dualbound)))
+         break;
+
+      selected = selectFeasHeuristics();
+      if (selected.empty())
+         break;
+
+      Message::debug("Portfolio round {}: {} heuristics", round + 1,
+                     selected.size());
+   }
    auto tend = Timer::now();
 
    assert(checkSolFeas(mip));
 
-   auto [feas_min_cost_heur, feas_min_cost_sol, feas_min_cost,
-         feas_nsols] = getFeasSolSummary();
+   auto [feas_min_cost_heur, feas_min_cost, feas_nsols] =
+       getFeasSolSummary();
 
    if (feas_nsols == 0)
    {
       Message::print("No solution found after {} sec.",
                      Timer::seconds(tend, t0));
-      return {-1, -1, 0.0};
+      return {-1, 0.0};
    }
 
-   assert(feas_min_cost_sol != -1 && feas_min_cost_heur != -1);
+   assert(feas_min_cost_heur != -1);
 
-   auto best_sol =
-       feas_solutions_pools[feas_min_cost_heur][feas_min_cost_sol].first;
-   double best_cost =
-       feas_solutions_pools[feas_min_cost_heur][feas_min_cost_sol].second;
+   auto best_sol = feas_solutions_pools[feas_min_cost_heur].best().first;
+   double best_cost = feas_min_cost;
 
-   checkFeasibility(mip, best_sol, 1e-9, 1e-6);
    maxOutSolution(mip, best_sol, best_cost);
-   checkFeasibility(mip, best_sol, 1e-6, 1e-9);
+   assert(evaluateSolution(mip, best_sol, true, true).feasible);
 
    // TODO
    double gap = 100.0 * std::fabs(feas_min_cost - result.obj) /
@@ -235,51 +366,112 @@ Search::run_feas_search(const MIP& mip, TimeLimit tlimit,
       if (feas_solutions_pools[i].size() == 0)
          fmt::format_to(buf, "{}", "--");
       else
-         fmt::format_to(buf, "{:0.2f}", feas_solutions_pools[i][0].second);
+         fmt::format_to(buf, "{:0.2f}",
+                        feas_solutions_pools[i].best().second);
 
       if (i == static_cast<size_t>(feas_min_cost_heur))
          Message::print("  {:<15} {:<15.1f} {:<10} {:<}*",
                         feas_heuristics[i]->getName(),
                         feas_heuristics[i]->getRunTime(),
-                        feas_solutions_pools[i].size(), to_string(buf));
+                        feas_solutions_pools[i].getNFound(),
+                        to_string(buf));
       else
          Message::print("  {:<15} {:<15.1f} {:<10} {:<}",
                         feas_heuristics[i]->getName(),
                         feas_heuristics[i]->getRunTime(),
-                        feas_solutions_pools[i].size(), to_string(buf));
+                        feas_solutions_pools[i].getNFound(),
+                        to_string(buf));
    }
    Message::print("");
 
-   return {feas_min_cost_heur, feas_min_cost_sol, result.obj};
+   return {feas_min_cost_heur, result.obj};
 }
 
-std::pair<int, int>
-Search::run_impr_search(const MIP& mip, TimeLimit tlimit,
-                        std::shared_ptr<LPSolver> lpSolver,
-                        const std::vector<Activity>& activities,
-                        const std::vector<double>& best_sol,
-                        double best_cost, double dualbound,
-                        Timer::time_point t0)
+void
+Search::start_impr_search(const MIP& mip, TimeLimit tlimit,
+                          std::shared_ptr<LPSolver> lpSolver,
+                          const std::vector<Activity>& activities,
+                          double dualbound)
 {
-   // run improvement heuristics
-   auto run_impr = [&](tbb::blocked_range<size_t>& range) -> void {
-      for (size_t i = range.begin(); i != range.end(); ++i)
-         impr_heuristics[i]->execute(
-             mip, mip.getLB(), mip.getUB(), activities, best_sol,
-             best_cost, lpSolver, tlimit, impr_solutions_pools[i]);
-   };
+   std::unique_lock lock(impr_mutex);
+
+   // the improvement budget starts with the first incumbent
+   if (!impr_limit)
+      impr_limit.emplace(Timer::now(), limits.improvement,
+                         tlimit.getToken());
+
+   if (!global_pool.hasSolution() || impr_limit->reached())
+      return;
+
+   // the incumbent is good enough, the running heuristics are stopped
+   if (isGapClosed(global_pool.getCutoff(), dualbound))
+   {
+      search_token.cancel();
+      return;
+   }
+
+   for (size_t i = 0; i < impr_heuristics.size(); ++i)
+   {
+      // the running ones restart by themselves on the new incumbent
+      if (impr_running[i])
+         continue;
+
+      impr_running[i] = true;
+      impr_started = true;
+      impr_tasks.run([=, &mip, &activities, limit = *impr_limit]() {
+         run_impr_heuristic(i, mip, limit, lpSolver, activities,
+                            dualbound);
+      });
+   }
+}
+
+void
+Search::run_impr_heuristic(size_t i, const MIP& mip, TimeLimit tlimit,
+                           std::shared_ptr<LPSolver> lpSolver,
+                           const std::vector<Activity>& activities,
+                           double dualbound)
+{
+   while (true)
+   {
+      auto [best_sol, best_cost] = global_pool.getBest();
+
+      impr_heuristics[i]->execute(mip, mip.getLB(), mip.getUB(),
+                                  activities, best_sol, best_cost,
+                                  lpSolver, tlimit,
+                                  impr_solutions_pools[i]);
 
-   Message::print("Running improvement heuristics:");
-   tbb::parallel_for(tbb::blocked_range<size_t>{0, impr_heuristics.size()},
-                     std::move(run_impr));
+      // the lock makes sure that an incumbent found after this check
+      // starts the heuristic again
+      std::unique_lock lock(impr_mutex);
+
+      double cutoff = global_pool.getCutoff();
+      if (!(cutoff < best_cost) || isGapClosed(cutoff, dualbound) ||
+          tlimit.reached(Timer::now()))
+      {
+         impr_running[i] = false;
+         return;
+      }
+   }
+}
+
+int
+Search::wait_impr_search(double dualbound, Timer::time_point t0)
+{
+   impr_tasks.wait();
+   global_pool.setListener(nullptr);
+
+   if (!impr_started)
+      return -1;
+
+   Message::print("Improvement heuristics:");
    auto tend = Timer::now();
 
-   auto [impr_min_cost_heur, impr_min_cost_sol, impr_min_cost,
-         impr_nsols] = getImprSolSummary();
+   auto [impr_min_cost_heur, impr_min_cost, impr_nsols] =
+       getImprSolSummary();
 
    if (impr_nsols > 0)
    {
-      assert(impr_min_cost_sol != -1 && impr_min_cost_heur != -1);
+      assert(impr_min_cost_heur != -1);
 
       double gap = 100.0 * std::fabs(impr_min_cost - dualbound) /
                    (std::fabs(dualbound) + 1e-6);
@@ -303,30 +495,32 @@ Search::run_impr_search(const MIP& mip, TimeLimit tlimit,
             fmt::format_to(buf, "{}", "--");
          else
             fmt::format_to(buf, "{:0.2f}",
-                           impr_solutions_pools[i][0].second);
+                           impr_solutions_pools[i].best().second);
 
          if (i == static_cast<size_t>(impr_min_cost_heur))
             Message::print("  {:<15} {:<15.1f} {:<10} {:<}*",
                            impr_heuristics[i]->getName(),
                            impr_heuristics[i]->getRunTime(),
-                           impr_solutions_pools[i].size(), to_string(buf));
+                           impr_solutions_pools[i].getNFound(),
+                           to_string(buf));
          else
             Message::print("  {:<15} {:<15.1f} {:<10} {:<}",
                            impr_heuristics[i]->getName(),
                            impr_heuristics[i]->getRunTime(),
-                           impr_solutions_pools[i].size(), to_string(buf));
+                           impr_solutions_pools[i].getNFound(),
+                           to_string(buf));
       }
 
-      return {impr_min_cost_heur, impr_min_cost_sol};
+      return impr_min_cost_heur;
    }
    else
       Message::print("No improved solution found");
 
-   return {-1, -1};
+   return -1;
 }
 
 std::optional<std::vector<double>>
-Search::run(const MIP& mip, int seconds,
+Search::run(const MIP& mip, const SearchLimits& _limits,
             std::optional<std::vector<double>> optSol)
 {
    auto st = mip.getStats();
@@ -335,40 +529,54 @@ Search::run(const MIP& mip, int seconds,
                   st.ncols, st.nbin, st.nint, st.ncont, st.nrows,
                   st.nnzmat);
    auto t0 = Timer::now();
-   TimeLimit tlimit(Timer::now(), seconds);
+
+   // stops the heuristics and their lp solves at the time limit or as
+   // soon as the gap is closed
+   limits = _limits;
+   search_token = CancellationToken();
+   TimeLimit tlimit(t0, limits.total, search_token);
+
+   // nothing is kept from a previous run
+   global_pool.clear();
+   for (auto& pool : feas_solutions_pools)
+      pool.clear();
+   for (auto& pool : impr_solutions_pools)
+      pool.clear();
+   std::fill(feas_stats.begin(), feas_stats.end(), HeuristicStats());
+   std::fill(impr_running.begin(), impr_running.end(), false);
+   for (auto& heur : feas_heuristics)
+      heur->resetRunTime();
+   for (auto& heur : impr_heuristics)
+      heur->resetRunTime();
+
+   impr_limit.reset();
+   impr_started = false;
+
    auto lpSolver = std::make_shared<MySolver>(mip);
    std::vector activities = computeActivities(mip);
 
    if (!optSol)
    {
-      auto [feas_best_heur, feas_best_sol, dualbound] =
+      auto [feas_best_heur, dualbound] =
           run_feas_search(mip, tlimit, lpSolver, activities);
 
-      if (feas_best_heur < 0 || feas_best_sol < 0)
+      if (feas_best_heur < 0)
+      {
+         global_pool.setListener(nullptr);
          return {};
+      }
 
-      const auto best_sol =
-          feas_solutions_pools[feas_best_heur][feas_best_sol].first;
-      double best_cost =
-          feas_solutions_pools[feas_best_heur][feas_best_sol].second;
-
-      if ((best_cost - dualbound) / (std::fabs(dualbound) + 1e-6) < 1e-3)
-         return {std::move(best_sol)};
-
-      auto [impr_best_heur, impr_best_sol] =
-          run_impr_search(mip, tlimit, lpSolver, activities, best_sol,
-                          best_cost, dualbound, t0);
-
-      if (impr_best_heur < 0 || impr_best_sol < 0)
-         return {std::move(best_sol)};
+      wait_impr_search(dualbound, t0);
 
-      return impr_solutions_pools[impr_best_heur][impr_best_sol].first;
+      // the best solution of both phases
+      return global_pool.getBest().first;
    }
    else
    {
       Message::print("Solving LP:");
       auto t0 = Timer::now();
-      auto result = lpSolver->solve(Algorithm::DUAL);
+      TimeLimit lplimit(t0, limits.rootlp, tlimit.getToken());
+      auto result = lpSolver->solve(Algorithm::DUAL, lplimit.getToken());
       auto t1 = Timer::now();
       Message::print("Solved in {:0.2f}", Timer::seconds(t1, t0));
 
@@ -401,13 +609,16 @@ Search::run(const MIP& mip, int seconds,
       Message::print("Input solution has: objective {:0.4f}, gap {:0.2f}%",
                      best_cost, gap);
 
-      auto [impr_best_heur, impr_best_sol] =
-          run_impr_search(mip, tlimit, lpSolver, activities, best_sol,
-                          best_cost, dualbound, t0);
+      // the improvement heuristics start from the input solution and
+      // start again on each improved solution
+      global_pool.setListener([&, tlimit, lpSolver, dualbound]() {
+         start_impr_search(mip, tlimit, lpSolver, activities, dualbound);
+      });
+      global_pool.add(best_sol, best_cost);
 
-      if (impr_best_heur < 0 || impr_best_sol < 0)
+      if (wait_impr_search(dualbound, t0) < 0)
          return {};
 
-      return impr_solutions_pools[impr_best_heur][impr_best_sol].first;
+      return global_pool.getBest().first;
    }
 }
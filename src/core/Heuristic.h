@@ -11,13 +11,20 @@
 #include "io/Config.h"
 #include "io/Message.h"
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <variant>
 #include <vector>
 
 #include <optional>
 #include <tbb/mutex.h>
+#include <tbb/task_group.h>
 
 class Heuristic
 {
@@ -36,76 +43,221 @@ class Heuristic
    std::string name;
 };
 
-class SolutionPool
+// best solution found by all the heuristics of a search
+// heuristics running in parallel add their solutions concurrently, the
+// objective of the incumbent is published atomically so that reading the
+// cutoff never takes the lock
+class GlobalSolutionPool
 {
  public:
-   using value_type = std::pair<std::vector<double>, double>;
+   GlobalSolutionPool() : best_obj(Num::infinity()) {}
 
-   void add(std::vector<double>&& sol, double obj)
+   // called after each new incumbent by the thread that found it
+   void setListener(std::function<void()> _listener)
    {
-      // check for duplicates
-      for (size_t i = 0; i < solution_list.size(); ++i)
-      {
-         if (!Num::isFeasEQ(solution_list[i].second, obj))
-            continue;
-
-         bool same = true;
-         for (size_t j = 0; j < sol.size(); ++j)
-         {
-            if (!Num::isFeasEQ(solution_list[i].first[j], sol[j]))
-            {
-               same = false;
-               break;
-            }
-         }
-
-         if (same)
-            return;
-      }
+      listener = std::move(_listener);
+   }
+
+   // returns true if the solution is the new incumbent, the solution is
+   // only copied in that case
+   bool add(const std::vector<double>& sol, double obj)
+   {
+      if (!(obj < getCutoff()))
+         return false;
 
-      // look for the right position
-      size_t pos = 0;
-      while (pos < solution_list.size() && obj > solution_list[pos].second)
       {
-         ++pos;
+         std::unique_lock lock(mutex);
+
+         if (!(obj < best_obj.load(std::memory_order_relaxed)))
+            return false;
+
+         best_sol = sol;
+         best_obj.store(obj, std::memory_order_release);
+         ++nimprovements;
       }
 
-      if (pos == solution_list.size())
-         solution_list.emplace_back(std::move(sol), obj);
-      else
-      {
-         std::vector<value_type> buffer(solution_list.size() + 1);
+      if (listener)
+         listener();
 
-         for (size_t i = 0; i < pos; ++i)
-            buffer[i] = std::move(solution_list[i]);
+      return true;
+   }
 
-         buffer[pos] = std::make_pair(std::move(sol), obj);
+   // objective of the incumbent, infinity if there is none
+   double getCutoff() const
+   {
+      return best_obj.load(std::memory_order_acquire);
+   }
 
-         for (size_t i = pos + 1; i < buffer.size(); ++i)
-            buffer[i] = std::move(solution_list[i - 1]);
+   bool hasSolution() const { return !Num::isInf(getCutoff()); }
 
-         solution_list = std::move(buffer);
-      }
+   // the incumbent and its objective
+   std::pair<std::vector<double>, double> getBest() const
+   {
+      std::unique_lock lock(mutex);
+      return {best_sol, best_obj.load(std::memory_order_relaxed)};
+   }
 
-#ifndef NDEBUG
-      for (size_t i = 1; i < solution_list.size(); ++i)
-      {
-         assert(solution_list[i].first.size() ==
-                solution_list[i - 1].first.size());
-         assert(solution_list[i].second <= solution_list[i - 1].second);
-      }
-#endif
+   int getNImprovements() const
+   {
+      std::unique_lock lock(mutex);
+      return nimprovements;
    }
 
-   size_t size() const { return solution_list.size(); }
+   // forgets the incumbent, the listener is kept
+   void clear()
+   {
+      std::unique_lock lock(mutex);
+      best_sol.clear();
+      best_obj.store(Num::infinity(), std::memory_order_release);
+      nimprovements = 0;
+   }
 
-   const value_type& operator[](size_t id) const
+ private:
+   mutable tbb::mutex mutex;
+   std::atomic<double> best_obj;
+   std::vector<double> best_sol;
+   int nimprovements = 0;
+   std::function<void()> listener;
+};
+
+// solutions found by one heuristic ordered by objective, the solutions
+// are also given to the global pool of the search if there is one
+// duplicates are detected with a 64-bit fingerprint of the values rounded
+// to the feasibility tolerance, once the pool is full the worst solution
+// is evicted
+class SolutionPool
+{
+   // solutions with the same objective are ordered by fingerprint
+   using Key = std::pair<double, uint64_t>;
+
+ public:
+   using value_type = std::pair<std::vector<double>, double>;
+   using const_iterator = std::map<Key, value_type>::const_iterator;
+
+   static constexpr size_t default_capacity = 64;
+
+   explicit SolutionPool(size_t _capacity = default_capacity)
+       : capacity(_capacity)
+   {
+      assert(capacity > 0);
+   }
+
+   void setGlobal(GlobalSolutionPool* pool) { global = pool; }
+
+   // removes the solutions, the capacity and the global pool are kept
+   void clear()
    {
-      return solution_list[id];
+      solutions.clear();
+      fingerprints.clear();
+      nfound = 0;
    }
 
+   // evicts the worst solutions if the pool holds more than capacity
+   void setCapacity(size_t _capacity)
+   {
+      assert(_capacity > 0);
+      capacity = _capacity;
+
+      while (solutions.size() > capacity)
+         evictWorst();
+   }
+
+   // objective a solution has to beat to improve on the incumbent of the
+   // search, or on the best solution of this pool without global pool
+   double getCutoff() const
+   {
+      if (global)
+         return global->getCutoff();
+      if (solutions.empty())
+         return Num::infinity();
+      return best().second;
+   }
+
+   // true if no solution with an objective of at least bound can improve
+   // the incumbent
+   bool isCutOff(double bound) const
+   {
+      return Num::isFeasGE(bound, getCutoff());
+   }
+
+   void add(std::vector<double>&& sol, double obj)
+   {
+      if (global)
+         global->add(sol, obj);
+
+      // not better than the worst solution of a full pool
+      if (solutions.size() == capacity &&
+          !(obj < std::prev(solutions.end())->first.first))
+         return;
+
+      uint64_t fingerprint = getFingerprint(sol);
+      if (!fingerprints.insert(fingerprint).second)
+         return;
+
+      assert(solutions.empty() ||
+             solutions.begin()->second.first.size() == sol.size());
+
+      solutions.emplace(Key(obj, fingerprint),
+                        value_type(std::move(sol), obj));
+      ++nfound;
+
+      if (solutions.size() > capacity)
+         evictWorst();
+   }
+
+   size_t size() const { return solutions.size(); }
+
+   bool empty() const { return solutions.empty(); }
+
+   // number of distinct solutions added, evicted ones included
+   size_t getNFound() const { return nfound; }
+
+   const value_type& best() const
+   {
+      assert(!solutions.empty());
+      return solutions.begin()->second;
+   }
+
+   // iterates over the pairs (key, solution) by increasing objective
+   const_iterator begin() const { return solutions.begin(); }
+
+   const_iterator end() const { return solutions.end(); }
+
  private:
-   std::vector<value_type> solution_list;
+   void evictWorst()
+   {
+      auto worst = std::prev(solutions.end());
+      fingerprints.erase(worst->first.second);
+      solutions.erase(worst);
+   }
+
+   static uint64_t getFingerprint(const std::vector<double>& sol)
+   {
+      uint64_t hash = sol.size();
+
+      for (double val : sol)
+      {
+         // adding 0.0 maps -0.0 to 0.0
+         double rounded = Num::round(val / Num::feastol()) + 0.0;
+
+         uint64_t bits;
+         std::memcpy(&bits, &rounded, sizeof(bits));
+
+         hash = (hash ^ bits) * 0x100000001b3ULL;
+         hash ^= hash >> 29;
+      }
+
+      // final mix of splitmix64
+      hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+      return hash ^ (hash >> 31);
+   }
+
+   std::map<Key, value_type> solutions;
+   HashSet<uint64_t> fingerprints;
+   size_t capacity;
+   size_t nfound = 0;
+   GlobalSolutionPool* global = nullptr;
 };
 
 class FeasibilityHeuristic : public Heuristic
@@ -132,6 +284,11 @@ class FeasibilityHeuristic : public Heuristic
                 SolutionPool& pool)
    {
       auto t0 = Timer::now();
+
+      // the search has been cancelled or is out of time
+      if (limit.reached(t0))
+         return;
+
       search(mip, lb, ub, act, res, lpsol, integer, lpsolver, limit, pool);
       auto t1 = Timer::now();
 
@@ -140,6 +297,8 @@ class FeasibilityHeuristic : public Heuristic
 
    float getRunTime() const { return runtime; }
 
+   void resetRunTime() { runtime = 0.0; }
+
  private:
    virtual void search(
        const MIP&,               
@@ -178,6 +337,10 @@ class ImprovementHeuristic : public Heuristic
        SolutionPool& pool)
    {
       auto t0 = Timer::now();
+
+      if (limit.reached(t0))
+         return;
+
       improve(mip, lb, ub, act, best_int_sol, best_int_cost, lpsolver,
               limit, pool);
       auto t1 = Timer::now();
@@ -187,6 +350,8 @@ class ImprovementHeuristic : public Heuristic
 
    float getRunTime() const { return runtime; }
 
+   void resetRunTime() { runtime = 0.0; }
+
  private:
    virtual void improve(
        const MIP&,                              
@@ -202,6 +367,17 @@ class ImprovementHeuristic : public Heuristic
    float runtime;
 };
 
+// time budgets of a search in seconds, the budgets of the phases count
+// from the start of their phase and are bounded by the total one
+// the improvement phase starts with the first incumbent
+struct SearchLimits
+{
+   double total = Num::infinity();
+   double rootlp = Num::infinity();
+   double feasibility = Num::infinity();
+   double improvement = Num::infinity();
+};
+
 class Search
 {
  public:
@@ -209,30 +385,70 @@ class Search
           std::initializer_list<ImprovementHeuristic*>, const Config&);
 
    std::optional<std::vector<double>>
-   run(const MIP&, int, std::optional<std::vector<double>>);
+   run(const MIP&, const SearchLimits&,
+       std::optional<std::vector<double>>);
 
  private:
-   std::tuple<int, int, double, int> getFeasSolSummary() const;
+   // heuristic with the best solution, its objective and the number of
+   // solutions found
+   std::tuple<int, double, int> getFeasSolSummary() const;
 
-   std::tuple<int, int, double, int> getImprSolSummary() const;
+   std::tuple<int, double, int> getImprSolSummary() const;
 
    bool checkSolFeas(const MIP&) const;
 
  private:
-   std::tuple<int, int, double>
+   // feasibility heuristics to run again, by decreasing score
+   std::vector<size_t> selectFeasHeuristics() const;
+
+   std::pair<int, double>
    run_feas_search(const MIP&, TimeLimit, std::shared_ptr<LPSolver>,
                    const std::vector<Activity>&);
 
-   std::pair<int, int> run_impr_search(const MIP&, TimeLimit,
-                                       std::shared_ptr<LPSolver>,
-                                       const std::vector<Activity>&,
-                                       const std::vector<double>&, double,
-                                       double, Timer::time_point);
+   // starts the improvement heuristics that are not running on the
+   // incumbent of the global pool
+   void start_impr_search(const MIP&, TimeLimit, std::shared_ptr<LPSolver>,
+                          const std::vector<Activity>&, double);
+
+   // runs an improvement heuristic until it ends without a new incumbent
+   // having been found in the meantime
+   void run_impr_heuristic(size_t, const MIP&, TimeLimit,
+                           std::shared_ptr<LPSolver>,
+                           const std::vector<Activity>&, double);
+
+   // waits for the improvement heuristics, returns the heuristic with the
+   // best improved solution or -1
+   int wait_impr_search(double, Timer::time_point);
 
    std::vector<std::unique_ptr<FeasibilityHeuristic>> feas_heuristics;
    std::vector<std::unique_ptr<ImprovementHeuristic>> impr_heuristics;
    std::vector<SolutionPool> feas_solutions_pools;
    std::vector<SolutionPool> impr_solutions_pools;
+   // results of the runs of a feasibility heuristic
+   struct HeuristicStats
+   {
+      int nruns = 0;
+      double reward = 0.0;
+   };
+   std::vector<HeuristicStats> feas_stats;
+   int portfolio_rounds = 3;
+   // runtime added to the heuristics' runtimes to score them
+   static constexpr double min_runtime = 1e-3;
+
+   // incumbent shared by the heuristics of both phases
+   GlobalSolutionPool global_pool;
+
+   // cancels the heuristics of the current run
+   CancellationToken search_token;
+   SearchLimits limits;
+
+   // improvement heuristics started while the feasibility heuristics run
+   tbb::task_group impr_tasks;
+   tbb::mutex impr_mutex;
+   std::vector<bool> impr_running;
+   bool impr_started = false;
+   // set when the first improvement heuristic is started
+   std::optional<TimeLimit> impr_limit;
 };
 
 #endif
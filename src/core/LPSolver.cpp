@@ -1,5 +1,8 @@
 #include "LPSolver.h"
 
+#include <numeric>
+#include <tuple>
+
 std::string
 to_str(LPResult::Status st)
 {
@@ -18,3 +21,176 @@ to_str(LPResult::Status st)
    assert(0);
    return "";
 }
+
+std::unique_ptr<LPSolver>
+LPSolver::clone() const
+{
+   const auto& lb = mip.getLB();
+   const auto& ub = mip.getUB();
+   const auto& obj = mip.getObj();
+   int ncols = mip.getNCols();
+
+   // only the columns that differ from the problem are copied, the lock
+   // is not held while the copy loads the matrix
+   std::vector<double> copylb(ncols);
+   std::vector<double> copyub(ncols);
+   std::vector<double> copyobj(ncols);
+   std::vector<int> boundcols;
+   std::vector<int> objcols;
+   LPBasis basis;
+   {
+      std::unique_lock guard(copyLock);
+
+      for (int col = 0; col < ncols; ++col)
+      {
+         std::tie(copylb[col], copyub[col]) = getBounds(col);
+         if (copylb[col] != lb[col] || copyub[col] != ub[col])
+            boundcols.push_back(col);
+
+         copyobj[col] = getObjective(col);
+         if (copyobj[col] != obj[col])
+            objcols.push_back(col);
+      }
+
+      basis = getBasis();
+   }
+
+   auto copy = makeNew(mip);
+
+   if (!boundcols.empty())
+      copy->doChangeBounds(boundcols, copylb, copyub);
+
+   if (!objcols.empty())
+      copy->doChangeObjective(objcols, copyobj);
+
+   if (!basis.empty())
+      copy->setBasis(basis);
+
+   return copy;
+}
+
+void
+LPSolver::changeBounds(int column, double lb, double ub)
+{
+   if (!checkpoints.empty())
+   {
+      auto [oldlb, oldub] = getBounds(column);
+      trail.push_back({column, false, oldlb, oldub});
+   }
+
+   doChangeBounds(column, lb, ub);
+}
+
+void
+LPSolver::changeBounds(const std::vector<double>& lb,
+                       const std::vector<double>& ub)
+{
+   if (!checkpoints.empty())
+   {
+      for (size_t col = 0; col < lb.size(); ++col)
+      {
+         auto [oldlb, oldub] = getBounds(col);
+         trail.push_back({static_cast<int>(col), false, oldlb, oldub});
+      }
+   }
+
+   doChangeBounds(lb, ub);
+}
+
+void
+LPSolver::changeBounds(const std::vector<int>& columns,
+                       const std::vector<double>& lb,
+                       const std::vector<double>& ub)
+{
+   if (!checkpoints.empty())
+   {
+      for (int col : columns)
+      {
+         auto [oldlb, oldub] = getBounds(col);
+         trail.push_back({col, false, oldlb, oldub});
+      }
+   }
+
+   doChangeBounds(columns, lb, ub);
+}
+
+void
+LPSolver::fixColumns(int ncols, const std::vector<double>& vals)
+{
+   std::vector<int> columns(ncols);
+   std::iota(columns.begin(), columns.end(), 0);
+
+   changeBounds(columns, vals, vals);
+}
+
+void
+LPSolver::changeObjective(int column, double coef)
+{
+   if (!checkpoints.empty())
+      trail.push_back({column, true, getObjective(column), 0.0});
+
+   doChangeObjective(column, coef);
+}
+
+void
+LPSolver::changeObjective(const std::vector<int>& columns,
+                          const std::vector<double>& coefs)
+{
+   if (!checkpoints.empty())
+   {
+      for (int col : columns)
+         trail.push_back({col, true, getObjective(col), 0.0});
+   }
+
+   doChangeObjective(columns, coefs);
+}
+
+void
+LPSolver::changeObjective(const std::vector<double>& coefs)
+{
+   std::vector<int> columns(coefs.size());
+   std::iota(columns.begin(), columns.end(), 0);
+
+   changeObjective(columns, coefs);
+}
+
+void
+LPSolver::checkpoint()
+{
+   checkpoints.push_back({getBasis(), trail.size()});
+}
+
+void
+LPSolver::rollback()
+{
+   assert(!checkpoints.empty());
+   Checkpoint& last = checkpoints.back();
+
+   // undo the changes in reverse order
+   for (size_t i = trail.size(); i > last.trailsize; --i)
+   {
+      const Change& change = trail[i - 1];
+
+      if (change.objective)
+         doChangeObjective(change.column, change.lb);
+      else
+         doChangeBounds(change.column, change.lb, change.ub);
+   }
+   trail.resize(last.trailsize);
+
+   if (!last.basis.empty())
+      setBasis(last.basis);
+
+   checkpoints.pop_back();
+}
+
+void
+LPSolver::discardCheckpoint()
+{
+   assert(!checkpoints.empty());
+   checkpoints.pop_back();
+
+   // the changes are only needed by the enclosing checkpoints
+   if (checkpoints.empty())
+      trail.clear();
+}
@@ -2,7 +2,9 @@
 #define LPSOLVER_HPP
 
 #include "MIP.h"
+#include "Timer.h"
 #include "fmt/format.h"
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <tbb/mutex.h>
@@ -34,32 +36,129 @@ enum class Algorithm
    DUAL,
 };
 
+// simplex basis, the status of each column and of the slack of each row
+// a basis is only meaningful for the kind of solver it was taken from
+struct LPBasis
+{
+   enum Status : uint8_t
+   {
+      BASIC,
+      AT_LOWER,
+      AT_UPPER,
+      // nonbasic free variable
+      AT_ZERO,
+      FIXED
+   };
+
+   std::vector<Status> colStatus;
+   std::vector<Status> rowStatus;
+
+   // the solver has no basis yet
+   bool empty() const { return colStatus.empty(); }
+};
+
+// the problem given at construction must outlive the solver
 class LPSolver
 {
  public:
-   LPSolver() = default;
+   explicit LPSolver(const MIP& _mip) : mip(_mip) {}
 
    virtual ~LPSolver() = default;
 
-   virtual LPResult solve(Algorithm) = 0;
+   // returns OTHER without solving if the token is already cancelled,
+   // the solve is stopped at the deadline of the token
+   virtual LPResult solve(Algorithm, const CancellationToken&) = 0;
 
-   std::unique_ptr<LPSolver> clone() const
-   {
-      std::unique_lock guard(copyLock);
-      return makeCopy();
-   }
+   // the copy is rebuilt from the problem, it holds its own constraint
+   // matrix and refactorizes on its first solve, only its bounds,
+   // objective and basis are copied from this solver
+   std::unique_ptr<LPSolver> clone() const;
+
+   void changeBounds(int column, double lb, double ub);
+
+   void changeBounds(const std::vector<double>&,
+                     const std::vector<double>&);
+
+   // changes the bounds of the columns in one call, the bounds are
+   // indexed by column
+   void changeBounds(const std::vector<int>& columns,
+                     const std::vector<double>& lb,
+                     const std::vector<double>& ub);
+
+   // fixes the columns 0, ..., ncols - 1 to their value in vals, the
+   // integer columns come first in the problem
+   void fixColumns(int ncols, const std::vector<double>& vals);
+
+   void changeObjective(int column, double coef);
+
+   // replaces the coefficients of all the columns
+   void changeObjective(const std::vector<double>& coefs);
+
+   // the coefficients are indexed by column
+   void changeObjective(const std::vector<int>& columns,
+                        const std::vector<double>& coefs);
+
+   // empty if the solver has no basis
+   virtual LPBasis getBasis() const = 0;
+
+   // the next solve is warm started from the basis
+   virtual void setBasis(const LPBasis&) = 0;
 
-   virtual void changeBounds(int column, double lb, double ub) = 0;
+   // the bound and objective changes made after a checkpoint are undone
+   // by a rollback, which also restores the basis of the checkpoint
+   // checkpoints are nested, the changes are only recorded while there is
+   // one
+   void checkpoint();
 
-   virtual void changeBounds(const std::vector<double>&,
-                             const std::vector<double>&) = 0;
+   void rollback();
 
-   virtual void changeObjective(int column, double coef) = 0;
+   // forgets the last checkpoint and keeps the changes made since
+   void discardCheckpoint();
 
  private:
-   virtual std::unique_ptr<LPSolver> makeCopy() const = 0;
+   // new solver of the same kind for the problem
+   virtual std::unique_ptr<LPSolver> makeNew(const MIP&) const = 0;
+
+   virtual void doChangeBounds(int column, double lb, double ub) = 0;
+
+   virtual void doChangeBounds(const std::vector<double>&,
+                               const std::vector<double>&) = 0;
+
+   virtual void doChangeBounds(const std::vector<int>&,
+                               const std::vector<double>&,
+                               const std::vector<double>&) = 0;
+
+   virtual void doChangeObjective(int column, double coef) = 0;
+
+   virtual void doChangeObjective(const std::vector<int>&,
+                                  const std::vector<double>&) = 0;
+
+   virtual std::pair<double, double> getBounds(int column) const = 0;
+
+   virtual double getObjective(int column) const = 0;
+
+   // previous bounds or objective coefficient of a column, the
+   // coefficient is kept in lb
+   struct Change
+   {
+      int column;
+      bool objective;
+      double lb;
+      double ub;
+   };
+
+   struct Checkpoint
+   {
+      LPBasis basis;
+      size_t trailsize;
+   };
+
+   const MIP& mip;
 
    mutable tbb::mutex copyLock;
+
+   std::vector<Change> trail;
+   std::vector<Checkpoint> checkpoints;
 };
 
 #endif
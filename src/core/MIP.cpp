@@ -4,19 +4,22 @@
 #include "io/Message.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <numeric>
 
-MIP::MIP(const Rows& rows, const Cols& cols, std::vector<double>&& coefsT,
-         std::vector<int>&& idxT, std::vector<int>&& rstartT,
-         std::vector<double>&& _rhs, std::vector<double>&& _lhs,
-         std::vector<double>&& _lbs, std::vector<double>&& _ubs,
-         std::vector<double>&& _obj, const dynamic_bitset<>& integer,
-         std::vector<int>& rowSize, std::vector<std::string>&& _varNames)
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+MIP::MIP(std::vector<double>&& coefsT, std::vector<int>&& idxT,
+         std::vector<int>&& rstartT, std::vector<double>&& _rhs,
+         std::vector<double>&& _lhs, std::vector<double>&& _lbs,
+         std::vector<double>&& _ubs, std::vector<double>&& _obj,
+         const dynamic_bitset<>& integer, int nrows,
+         NameTable&& _varNames, NameTable&& _consNames)
 {
-   int ncols = cols.size();
-   int nrows = rows.size();
+   int ncols = rstartT.size() - 1;
 
-   assert(ncols == static_cast<int>(rstartT.size() - 1));
    assert(idxT.size() == coefsT.size());
 
    // move constraint sides
@@ -27,127 +30,42 @@ MIP::MIP(const Rows& rows, const Cols& cols, std::vector<double>&& coefsT,
    lb = std::move(_lbs);
    ub = std::move(_ubs);
 
-   // move the objective
-   objective = std::move(_obj);
-
-   // fill the column major matrix
-   constMatrixT.coefficients = std::move(coefsT);
-   constMatrixT.indices = std::move(idxT);
-   constMatrixT.rowStart = std::move(rstartT);
-   constMatrixT.ncols = nrows;
-   constMatrixT.nrows = ncols;
+   // the column major matrix in the order of the file
+   SparseMatrix matrixT;
+   matrixT.coefficients = std::move(coefsT);
+   matrixT.indices = std::move(idxT);
+   matrixT.rowStart = std::move(rstartT);
+   matrixT.ncols = nrows;
+   matrixT.nrows = ncols;
    stats.ncols = ncols;
    stats.nrows = nrows;
 
    for (int col = 0; col < ncols; ++col)
    {
-      if (constMatrixT.rowStart[col + 1] == constMatrixT.rowStart[col])
+      if (matrixT.rowStart[col + 1] == matrixT.rowStart[col])
          Message::warn("column {} has zero support", col);
    }
 
-   // get the row-major matrix by transposing
-   constMatrix = transpose(constMatrixT, rowSize);
-
    // fill coefficients statistics
-   stats.nnzmat = constMatrixT.coefficients.size();
-   for (auto cost : objective)
+   stats.nnzmat = matrixT.coefficients.size();
+   for (auto cost : _obj)
    {
       if (cost != 0.0)
          ++stats.nnzobj;
    }
 
-   // move constraint names
-   consNames.resize(nrows);
-   for (auto& elem : rows)
-   {
-      int row = elem.second.second;
-      consNames[row] = std::move(elem.first);
-   }
-
-   // move variable names
-   assert(ncols == static_cast<int>(_varNames.size()));
-   varNames.resize(ncols);
-   for (int i = 0; i < ncols; ++i)
-      varNames[i] = std::move(_varNames[i]);
-
-   // compute the locks and max/min row support
-   downLocks.resize(ncols);
-   upLocks.resize(ncols);
-   for (int row = 0; row < nrows; ++row)
-   {
-      auto [rowcoefs, indices, rowsize] = getRow(row);
-
-      bool lhsfinite = !Num::isMinusInf(lhs[row]);
-      bool rhsfinite = !Num::isInf(rhs[row]);
-
-      if (lhs[row] == rhs[row])
-         ++stats.nequality;
-
-      for (int id = 0; id < rowsize; ++id)
-      {
-         int col = indices[id];
-         double coef = rowcoefs[id];
-         assert(rowcoefs[id] != 0.0);
-
-         if (lhsfinite)
-         {
-            if (coef > 0.0)
-               ++downLocks[col];
-            else
-               ++upLocks[col];
-         }
-         if (rhsfinite)
-         {
-            if (coef > 0.0)
-               ++upLocks[col];
-            else
-               ++downLocks[col];
-         }
-      }
-
-      stats.avgRowSupport += rowsize;
-      if (rowsize > stats.maxRowSupport)
-         stats.maxRowSupport = rowsize;
-      if (rowsize < stats.minRowSupport)
-         stats.minRowSupport = rowsize;
-   }
-
-   for (int col = 0; col < ncols; ++col)
-   {
-      auto [colcoefs, colindices, size] = getCol(col);
-
-      if (std::max(upLocks[col], downLocks[col]) > stats.maxLocks)
-         stats.maxLocks = std::max(upLocks[col], downLocks[col]);
-      if (std::min(upLocks[col], downLocks[col]) < stats.minLocks)
-         stats.minLocks = std::min(upLocks[col], downLocks[col]);
-
-      stats.avgColSupport += size;
-      if (size > stats.maxColSupport)
-         stats.maxColSupport = size;
-      if (size < stats.minColSupport)
-         stats.minColSupport = size;
-
-      if (integer[col])
-      {
-         if (lb[col] == 0.0 && ub[col] == 1.0)
-            ++stats.nbin;
-         else
-            ++stats.nint;
-      }
-      else
-         ++stats.ncont;
-   }
-
-   stats.avgRowSupport /= nrows;
-   stats.avgColSupport /= ncols;
+   // move the names
+   assert(_varNames.empty() ||
+          ncols == static_cast<int>(_varNames.size()));
+   assert(_consNames.empty() ||
+          nrows == static_cast<int>(_consNames.size()));
+   varNames = std::move(_varNames);
+   consNames = std::move(_consNames);
 
    // reorder variables | binary | int | continuous
    // permutation maps new id -> old id
    std::vector<int> permutation(ncols);
-   std::generate(std::begin(permutation), std::end(permutation), [](){
-      static int i = 0;
-      return i++;
-   });
+   std::iota(permutation.begin(), permutation.end(), 0);
 
    std::sort(permutation.begin(), permutation.end(),
              [&integer, this](int left, int right) -> bool {
@@ -163,72 +81,22 @@ MIP::MIP(const Rows& rows, const Cols& cols, std::vector<double>&& coefsT,
                        (leftint && !rightint);
              });
 
-   // permute all information related to columns
-   // permutation maps old id -> new id
-   std::vector<int> mapping(ncols);
-   dynamic_bitset<> int_buf(ncols);
-   std::vector<double> lb_buf(ncols);
-   std::vector<double> ub_buf(ncols);
-   std::vector<int> dl_buf(ncols);
-   std::vector<int> ul_buf(ncols);
-   std::vector<double> obj_buf(ncols);
-   std::vector<std::string> name_buf(ncols);
-   for (int i = 0; i < ncols; ++i)
-   {
-      mapping[permutation[i]] = i;
-
-      lb_buf[i] = lb[permutation[i]];
-      ub_buf[i] = ub[permutation[i]];
-      obj_buf[i] = objective[permutation[i]];
-      name_buf[i] = std::move(varNames[permutation[i]]);
-      dl_buf[i] = downLocks[permutation[i]];
-      ul_buf[i] = upLocks[permutation[i]];
-   }
+   // matrices, locks and statistics in the new order
+   build(matrixT, integer, permutation, _obj);
 
-   lb = std::move(lb_buf);
-   ub = std::move(ub_buf);
-   objective = std::move(obj_buf);
-   varNames = std::move(name_buf);
-   downLocks = std::move(dl_buf);
-   upLocks = std::move(ul_buf);
+   constMatrix.compress();
+   constMatrixT.compress();
 
-   // change the old indices by the new ones in the row major matrix
-   for (size_t i = 0; i < constMatrix.indices.size(); ++i)
+   if (hasNames())
    {
-      constMatrix.indices[i] = mapping[constMatrix.indices[i]];
-   }
+      NameTable name_buf;
+      name_buf.reserve(ncols, varNames.getChars().size());
+      for (int i = 0; i < ncols; ++i)
+         name_buf.push_back(varNames[permutation[i]]);
 
-   // permute the rows of the columns major matrix
-   SparseMatrix new_transp;
-   new_transp.ncols = nrows;
-   new_transp.nrows = ncols;
-   new_transp.coefficients.resize(stats.nnzmat);
-   new_transp.indices.resize(stats.nnzmat);
-   new_transp.rowStart.push_back(0);
-   int nnz = 0;
-   for (int i = 0; i < ncols; ++i)
-   {
-      int old_col = permutation[i];
-      int size = constMatrixT.rowStart[old_col + 1] -
-                 constMatrixT.rowStart[old_col];
-
-      std::memcpy(new_transp.coefficients.data() + nnz,
-                  constMatrixT.coefficients.data() +
-                      constMatrixT.rowStart[old_col],
-                  size * sizeof(double));
-
-      std::memcpy(new_transp.indices.data() + nnz,
-                  constMatrixT.indices.data() +
-                      constMatrixT.rowStart[old_col],
-                  size * sizeof(int));
-
-      nnz += size;
-      new_transp.rowStart.push_back(nnz);
+      varNames = std::move(name_buf);
    }
 
-   assert(nnz == stats.nnzmat);
-   constMatrixT = std::move(new_transp);
-
 #ifndef NDEBUG
    printStats(stats);
 #endif
@@ -259,82 +127,233 @@ MIP::operator=(MIP&& other) noexcept
    return *this;
 }
 
-SparseMatrix
-MIP::transpose(const SparseMatrix& matrix, const std::vector<int>& rowSize)
+// the columns are split in blocks with a similar number of nonzeros,
+// each block counts its entries per row and the counts are turned into
+// offsets, so the blocks fill the row major matrix independently and
+// the entries of a row keep the order of the columns in the file
+void
+MIP::build(const SparseMatrix& matrixT, const dynamic_bitset<>& integer,
+           const std::vector<int>& permutation,
+           const std::vector<double>& obj)
 {
-   int nnz = matrix.coefficients.size();
-   int ncols = matrix.nrows;
-   int nrows = matrix.ncols;
-
-   assert(matrix.rowStart.size() == static_cast<size_t>(matrix.nrows + 1));
-   assert(std::accumulate(rowSize.begin(), rowSize.end(), 0) == nnz);
-   assert(std::all_of(matrix.coefficients.begin(),
-                      matrix.coefficients.end(),
+   const int ncols = matrixT.nrows;
+   const int nrows = matrixT.ncols;
+   const int nnz = matrixT.coefficients.size();
+
+   assert(matrixT.rowStart.size() == static_cast<size_t>(ncols + 1));
+   assert(std::all_of(matrixT.coefficients.begin(),
+                      matrixT.coefficients.end(),
                       [](double coef) { return coef != 0.0; }));
 
-   SparseMatrix transposed;
-   transposed.nrows = nrows;
-   transposed.ncols = ncols;
-   transposed.coefficients.resize(nnz);
-   transposed.indices.resize(nnz);
+   // mapping maps old id -> new id
+   std::vector<int> mapping(ncols);
+   for (int i = 0; i < ncols; ++i)
+      mapping[permutation[i]] = i;
 
-   auto& rowStart = transposed.rowStart;
-   rowStart.reserve(nrows + 1);
-   rowStart.push_back(0);
+   // the counts of all blocks take at most as much memory as the indices
+   int nblocks = tbb::this_task_arena::max_concurrency();
+   if (nrows > 0)
+      nblocks = std::min(nblocks, std::max(1, nnz / nrows));
+   nblocks = std::max(1, std::min(nblocks, ncols));
 
-   std::vector<int> offset(nrows, 0);
+   std::vector<int> colBlocks(nblocks + 1);
+   std::vector<int> rowBlocks(nblocks + 1);
+   for (int b = 0; b < nblocks; ++b)
+   {
+      int target = static_cast<int64_t>(nnz) * b / nblocks;
+      colBlocks[b] = std::lower_bound(matrixT.rowStart.begin(),
+                                      matrixT.rowStart.end(), target) -
+                     matrixT.rowStart.begin();
+      colBlocks[b] = std::min(colBlocks[b], ncols);
+      rowBlocks[b] = static_cast<int64_t>(nrows) * b / nblocks;
+   }
+   colBlocks[nblocks] = ncols;
+   rowBlocks[nblocks] = nrows;
+
+   // entries of each row in each block
+   std::vector<int> counts(static_cast<size_t>(nblocks) * nrows, 0);
+   tbb::parallel_for(0, nblocks, [&](int b) {
+      int* count = counts.data() + static_cast<size_t>(b) * nrows;
+      for (int i = matrixT.rowStart[colBlocks[b]];
+           i < matrixT.rowStart[colBlocks[b + 1]]; ++i)
+         ++count[matrixT.indices[i]];
+   });
 
-   for (int i = 0; i < nrows; ++i)
-      rowStart.push_back(rowSize[i] + rowStart[i]);
+   // the statistics of each block are merged at the end
+   std::vector<Statistics> partial(nblocks);
 
-   for (int col = 0; col < ncols; ++col)
-   {
-      for (int rowid = matrix.rowStart[col];
-           rowid < matrix.rowStart[col + 1]; ++rowid)
+   constMatrix.nrows = nrows;
+   constMatrix.ncols = ncols;
+   constMatrix.rowStart.resize(nrows + 1);
+   constMatrix.rowStart[0] = 0;
+
+   tbb::parallel_for(0, nblocks, [&](int b) {
+      Statistics& st = partial[b];
+      for (int row = rowBlocks[b]; row < rowBlocks[b + 1]; ++row)
       {
-         int row = matrix.indices[rowid];
-         double coef = matrix.coefficients[rowid];
-         int rowstart = rowStart[row];
-
-         assert(coef != 0.0);
-         transposed.coefficients[rowstart + offset[row]] = coef;
-         transposed.indices[rowstart + offset[row]] = col;
-         ++offset[row];
-         assert(offset[row] <= rowSize[row]);
+         // the counts become the offsets of the blocks within the row
+         int rowsize = 0;
+         for (int k = 0; k < nblocks; ++k)
+         {
+            int& count = counts[static_cast<size_t>(k) * nrows + row];
+            int blocksize = count;
+            count = rowsize;
+            rowsize += blocksize;
+         }
+         constMatrix.rowStart[row + 1] = rowsize;
+
+         if (lhs[row] == rhs[row])
+            ++st.nequality;
+
+         st.maxRowSupport = std::max(st.maxRowSupport, rowsize);
+         st.minRowSupport = std::min(st.minRowSupport, rowsize);
       }
+   });
+
+   std::partial_sum(constMatrix.rowStart.begin(),
+                    constMatrix.rowStart.end(),
+                    constMatrix.rowStart.begin());
+   assert(constMatrix.rowStart[nrows] == nnz);
+
+   constMatrix.coefficients.resize(nnz);
+   constMatrix.indices.resize(nnz);
+
+   // the column major matrix with the columns in the new order
+   SparseMatrix permutedT;
+   permutedT.nrows = ncols;
+   permutedT.ncols = nrows;
+   permutedT.coefficients.resize(nnz);
+   permutedT.indices.resize(nnz);
+   permutedT.rowStart.resize(ncols + 1);
+   permutedT.rowStart[0] = 0;
+   for (int i = 0; i < ncols; ++i)
+   {
+      int oldcol = permutation[i];
+      permutedT.rowStart[i + 1] = permutedT.rowStart[i] +
+                                  matrixT.rowStart[oldcol + 1] -
+                                  matrixT.rowStart[oldcol];
    }
 
-   assert(std::all_of(transposed.coefficients.begin(),
-                      transposed.coefficients.end(),
-                      [](double coef) { return coef != 0.0; }));
+   std::vector<double> lb_buf(ncols);
+   std::vector<double> ub_buf(ncols);
+   objective.resize(ncols);
+   downLocks.resize(ncols);
+   upLocks.resize(ncols);
+
+   tbb::parallel_for(0, nblocks, [&](int b) {
+      Statistics& st = partial[b];
+      int* offset = counts.data() + static_cast<size_t>(b) * nrows;
+
+      for (int col = colBlocks[b]; col < colBlocks[b + 1]; ++col)
+      {
+         int newcol = mapping[col];
+         int begin = matrixT.rowStart[col];
+         int size = matrixT.rowStart[col + 1] - begin;
+         int down = 0;
+         int up = 0;
+
+         for (int i = begin; i < begin + size; ++i)
+         {
+            int row = matrixT.indices[i];
+            double coef = matrixT.coefficients[i];
+
+            int pos = constMatrix.rowStart[row] + offset[row]++;
+            constMatrix.coefficients[pos] = coef;
+            constMatrix.indices[pos] = newcol;
+
+            if (!Num::isMinusInf(lhs[row]))
+            {
+               if (coef > 0.0)
+                  ++down;
+               else
+                  ++up;
+            }
+            if (!Num::isInf(rhs[row]))
+            {
+               if (coef > 0.0)
+                  ++up;
+               else
+                  ++down;
+            }
+         }
+
+         std::memcpy(permutedT.coefficients.data() +
+                         permutedT.rowStart[newcol],
+                     matrixT.coefficients.data() + begin,
+                     size * sizeof(double));
+         std::memcpy(permutedT.indices.data() +
+                         permutedT.rowStart[newcol],
+                     matrixT.indices.data() + begin, size * sizeof(int));
+
+         downLocks[newcol] = down;
+         upLocks[newcol] = up;
+         lb_buf[newcol] = lb[col];
+         ub_buf[newcol] = ub[col];
+         objective[newcol] = obj[col];
+
+         st.maxLocks = std::max(st.maxLocks, std::max(up, down));
+         st.minLocks = std::min(st.minLocks, std::min(up, down));
+         st.maxColSupport = std::max(st.maxColSupport, size);
+         st.minColSupport = std::min(st.minColSupport, size);
+
+         if (integer[col])
+         {
+            if (lb[col] == 0.0 && ub[col] == 1.0)
+               ++st.nbin;
+            else
+               ++st.nint;
+         }
+         else
+            ++st.ncont;
+      }
+   });
+
+   lb = std::move(lb_buf);
+   ub = std::move(ub_buf);
+   constMatrixT = std::move(permutedT);
+
+   for (const Statistics& st : partial)
+   {
+      stats.nbin += st.nbin;
+      stats.nint += st.nint;
+      stats.ncont += st.ncont;
+      stats.nequality += st.nequality;
+      stats.maxRowSupport =
+          std::max(stats.maxRowSupport, st.maxRowSupport);
+      stats.minRowSupport =
+          std::min(stats.minRowSupport, st.minRowSupport);
+      stats.maxColSupport =
+          std::max(stats.maxColSupport, st.maxColSupport);
+      stats.minColSupport =
+          std::min(stats.minColSupport, st.minColSupport);
+      stats.maxLocks = std::max(stats.maxLocks, st.maxLocks);
+      stats.minLocks = std::min(stats.minLocks, st.minLocks);
+   }
 
-   return transposed;
+   if (nrows > 0)
+      stats.avgRowSupport = nnz / nrows;
+   if (ncols > 0)
+      stats.avgColSupport = nnz / ncols;
 }
 
 VectorView
 MIP::getRow(int row) const noexcept
 {
-   const double* coefBegin =
-       constMatrix.coefficients.data() + constMatrix.rowStart[row];
-   const int* indBegin =
-       constMatrix.indices.data() + constMatrix.rowStart[row];
-   const int size =
-       constMatrix.rowStart[row + 1] - constMatrix.rowStart[row];
-
-   return {coefBegin, indBegin, size};
+   const int start = constMatrix.rowStart[row];
+   const int size = constMatrix.rowStart[row + 1] - start;
+
+   return {constMatrix.getCoefs(start),
+           constMatrix.indices.data() + start, size};
 }
 
 VectorView
 MIP::getCol(int col) const noexcept
 {
-   const double* coefBegin =
-       constMatrixT.coefficients.data() + constMatrixT.rowStart[col];
-   const int* indBegin =
-       constMatrixT.indices.data() + constMatrixT.rowStart[col];
-   const int size =
-       constMatrixT.rowStart[col + 1] - constMatrixT.rowStart[col];
-
-   return {coefBegin, indBegin, size};
+   const int start = constMatrixT.rowStart[col];
+   const int size = constMatrixT.rowStart[col + 1] - start;
+
+   return {constMatrixT.getCoefs(start),
+           constMatrixT.indices.data() + start, size};
 }
 
 int
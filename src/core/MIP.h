@@ -1,11 +1,13 @@
 #ifndef MIP_HPP
 #define MIP_HPP
 
+#include "NameTable.h"
 #include "SparseMatrix.h"
 #include "dynamic_bitset/dynamic_bitset.hpp"
 #include "ska/Hash.hpp"
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifdef UNIT_TEST
@@ -22,22 +24,24 @@ enum ConsType
    OBJECTIVE,
 };
 
+// the names are views into the buffer of the MPS reader
+
 // name -> <contraint type, row id>
-using Rows = HashMap<std::string, std::pair<ConsType, int>>;
+using Rows = HashMap<std::string_view, std::pair<ConsType, int>>;
 
 // name -> column id
-using Cols = HashMap<std::string, int>;
+using Cols = HashMap<std::string_view, int>;
 
 struct VectorView
 {
-   VectorView(const double* _array, const int* _indices, int _size)
+   VectorView(CoefArray _array, const int* _indices, int _size)
        : coefs(_array), indices(_indices), size(_size)
    {
    }
 
    VectorView(const VectorView&) = default;
 
-   const double* coefs;
+   CoefArray coefs;
    const int* indices;
    int size;
 };
@@ -75,12 +79,13 @@ class MIP
  public:
    MIP() = default;
 
-   MIP(const Rows& rows, const Cols& cols, std::vector<double>&& coefsT,
-       std::vector<int>&& idxT, std::vector<int>&& rstartT,
-       std::vector<double>&& rhs, std::vector<double>&& lhs,
-       std::vector<double>&& lbs, std::vector<double>&& ubs,
-       std::vector<double>&& obj, const dynamic_bitset<>& integer,
-       std::vector<int>& rowSize, std::vector<std::string>&& colNames);
+   // the name tables are either empty or have one name per column/row
+   MIP(std::vector<double>&& coefsT, std::vector<int>&& idxT,
+       std::vector<int>&& rstartT, std::vector<double>&& rhs,
+       std::vector<double>&& lhs, std::vector<double>&& lbs,
+       std::vector<double>&& ubs, std::vector<double>&& obj,
+       const dynamic_bitset<>& integer, int nrows,
+       NameTable&& colNames, NameTable&& rowNames);
 
    MIP(MIP&&) = default;
 
@@ -100,12 +105,11 @@ class MIP
 
    const std::vector<double>& getRHS() const { return rhs; }
 
-   const std::vector<std::string>& getVarNames() const { return varNames; }
+   const NameTable& getVarNames() const { return varNames; }
 
-   const std::vector<std::string>& getConsNames() const
-   {
-      return consNames;
-   }
+   const NameTable& getConsNames() const { return consNames; }
+
+   bool hasNames() const { return !varNames.empty(); }
 
    VectorView getRow(int row) const noexcept;
 
@@ -121,10 +125,16 @@ class MIP
 
    Statistics getStats() const { return stats; }
 
+   // the snapshot format reads and writes the arrays directly
+   friend struct GPHFormat;
+
    PUBLIC_IF_TEST
 
-   static SparseMatrix transpose(const SparseMatrix&,
-                                 const std::vector<int>&);
+   // fills both matrices, the locks and the statistics in parallel from
+   // the column major matrix, permutation maps new id -> old id
+   void build(const SparseMatrix& matrixT, const dynamic_bitset<>& integer,
+              const std::vector<int>& permutation,
+              const std::vector<double>& obj);
 
    // min {obj*x}
    std::vector<double> objective;
@@ -138,8 +148,8 @@ class MIP
    std::vector<double> lb;
    std::vector<double> ub;
 
-   std::vector<std::string> varNames;
-   std::vector<std::string> consNames;
+   NameTable varNames;
+   NameTable consNames;
 
    // row-major sparse
    SparseMatrix constMatrix;
@@ -0,0 +1,55 @@
+#ifndef NAMETABLE_HPP
+#define NAMETABLE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// names stored contiguously, name i is chars[offsets[i], offsets[i + 1])
+// a table needs two allocations instead of one std::string per name
+class NameTable
+{
+ public:
+   NameTable() : offsets(1, 0) {}
+
+   NameTable(std::string&& _chars, std::vector<uint64_t>&& _offsets)
+       : chars(std::move(_chars)), offsets(std::move(_offsets))
+   {
+      assert(!offsets.empty() && offsets.back() == chars.size());
+   }
+
+   void reserve(size_t nnames, size_t nchars)
+   {
+      offsets.reserve(nnames + 1);
+      chars.reserve(nchars);
+   }
+
+   void push_back(std::string_view name)
+   {
+      chars.append(name);
+      offsets.push_back(chars.size());
+   }
+
+   std::string_view operator[](size_t i) const
+   {
+      assert(i < size());
+      return std::string_view(chars.data() + offsets[i],
+                              offsets[i + 1] - offsets[i]);
+   }
+
+   size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+   bool empty() const { return size() == 0; }
+
+   const std::string& getChars() const { return chars; }
+
+   const std::vector<uint64_t>& getOffsets() const { return offsets; }
+
+ private:
+   std::string chars;
+   std::vector<uint64_t> offsets;
+};
+
+#endif
@@ -65,6 +65,8 @@ struct Num
 
    static constexpr double infinity() { return infval; }
 
+   static constexpr double feastol() { return constol; }
+
    static constexpr double infval =
        std::numeric_limits<double>::infinity();
 
@@ -3,12 +3,39 @@
 #include "Numerics.h"
 #include "io/Message.h"
 
+#include <cstdint>
+
+// a drifted activity is recomputed from the bounds before the row is
+// declared infeasible, the bounds already hold the change being applied
+static bool
+isInfeasible(int row, std::vector<Activity>& activities,
+             const std::vector<double>& lhs, const std::vector<double>& rhs,
+             ActivityDrift* drift) noexcept
+{
+   auto violated = [&](const Activity& activity) {
+      return (activity.ninfmin == 0 &&
+              !Num::isFeasLE(activity.min, rhs[row])) ||
+             (activity.ninfmax == 0 &&
+              !Num::isFeasGE(activity.max, lhs[row]));
+   };
+
+   if (!violated(activities[row]))
+      return false;
+
+   if (!drift || !drift->drifted(row, activities[row]))
+      return true;
+
+   activities[row] = drift->recompute(row);
+   return violated(activities[row]);
+}
+
 template <>
 bool
 updateActivities<ChangedBound::LOWER>(
     VectorView colview, double oldlb, double newlb,
     std::vector<Activity>& activities, const std::vector<double>& lhs,
-    const std::vector<double>& rhs) noexcept
+    const std::vector<double>& rhs, PropagationTrail* trail,
+    ActivityDrift* drift) noexcept
 {
    auto [colcoefs, colindices, colsize] = colview;
    bool lbfinite = !Num::isInf(oldlb);
@@ -19,6 +46,9 @@ updateActivities<ChangedBound::LOWER>(
       int row = colindices[i];
       const double coef = colcoefs[i];
 
+      if (trail)
+         trail->pushActivity(row, activities[row], drift);
+
       if (coef > 0.0)
       {
          if (lbfinite)
@@ -40,10 +70,10 @@ updateActivities<ChangedBound::LOWER>(
          }
       }
 
-      if ((activities[row].ninfmin == 0 &&
-           !Num::isFeasLE(activities[row].min, rhs[row])) ||
-          (activities[row].ninfmax == 0 &&
-           !Num::isFeasGE(activities[row].max, lhs[row])))
+      if (drift)
+         drift->record(row, coef * (lbfinite ? newlb - oldlb : newlb));
+
+      if (isInfeasible(row, activities, lhs, rhs, drift))
          return false;
    }
 
@@ -55,9 +85,10 @@ bool
 updateActivities<ChangedBound::UPPER>(
     VectorView colview, double oldub, double newub,
     std::vector<Activity>& activities, const std::vector<double>& lhs,
-    const std::vector<double>& rhs) noexcept
+    const std::vector<double>& rhs, PropagationTrail* trail,
+    ActivityDrift* drift) noexcept
 {
-   const double* colcoefs = colview.coefs;
+   const CoefArray colcoefs = colview.coefs;
    const int* colindices = colview.indices;
    const int colsize = colview.size;
 
@@ -69,6 +100,9 @@ updateActivities<ChangedBound::UPPER>(
       int row = colindices[i];
       const double coef = colcoefs[i];
 
+      if (trail)
+         trail->pushActivity(row, activities[row], drift);
+
       if (coef > 0.0)
       {
          if (ubfinite)
@@ -90,10 +124,10 @@ updateActivities<ChangedBound::UPPER>(
          }
       }
 
-      if ((activities[row].ninfmin == 0 &&
-           !Num::isFeasLE(activities[row].min, rhs[row])) ||
-          (activities[row].ninfmax == 0 &&
-           !Num::isFeasGE(activities[row].max, lhs[row])))
+      if (drift)
+         drift->record(row, coef * (ubfinite ? newub - oldub : newub));
+
+      if (isInfeasible(row, activities, lhs, rhs, drift))
          return false;
    }
    return true;
@@ -104,7 +138,8 @@ updateActivities(VectorView colview, double oldlb, double newlb,
                  double oldub, double newub,
                  std::vector<Activity>& activities,
                  const std::vector<double>& lhs,
-                 const std::vector<double>& rhs) noexcept
+                 const std::vector<double>& rhs,
+                 PropagationTrail* trail, ActivityDrift* drift) noexcept
 {
    auto [colcoefs, colindices, colsize] = colview;
 
@@ -118,6 +153,14 @@ updateActivities(VectorView colview, double oldlb, double newlb,
       int row = colindices[i];
       const double coef = colcoefs[i];
 
+      if (trail)
+         trail->pushActivity(row, activities[row], drift);
+
+      if (drift)
+         drift->record(
+             row, std::fabs(coef * (lbfinite ? newlb - oldlb : newlb)) +
+                      std::fabs(coef * (ubfinite ? newub - oldub : newub)));
+
       if (coef > 0.0)
       {
          if (lbfinite)
@@ -154,10 +197,7 @@ updateActivities(VectorView colview, double oldlb, double newlb,
             --activities[row].ninfmax;
          }
 
-         if ((activities[row].ninfmin == 0 &&
-              !Num::isFeasLE(activities[row].min, rhs[row])) ||
-             (activities[row].ninfmax == 0 &&
-              !Num::isFeasGE(activities[row].max, lhs[row])))
+         if (isInfeasible(row, activities, lhs, rhs, drift))
             return false;
       }
    }
@@ -167,8 +207,8 @@ updateActivities(VectorView colview, double oldlb, double newlb,
 static bool
 propagateRow(const MIP& problem, int row,
              std::vector<Activity>& activities, std::vector<double>& lb,
-             std::vector<double>& ub,
-             std::vector<int>& changedCols) noexcept
+             std::vector<double>& ub, std::vector<int>& changedCols,
+             PropagationTrail* trail, ActivityDrift* drift) noexcept
 {
    auto [rowcoefs, rowindices, rowsize] = problem.getRow(row);
 
@@ -254,35 +294,58 @@ propagateRow(const MIP& problem, int row,
           (impliedub < ub[col] - 1e-6 && impubfinite))
       {
          auto colview = problem.getCol(col);
-         // update right and left
-         if (!updateActivities(colview, lb[col], impliedlb, ub[col],
-                               impliedub, activities, lhs, rhs))
-            return false;
+         double oldlb = lb[col];
+         double oldub = ub[col];
+
+         // the bounds are written first so that a drifted row can be
+         // recomputed from them
+         if (trail)
+            trail->pushBounds(col, oldlb, oldub);
 
          lb[col] = impliedlb;
          ub[col] = impliedub;
+
+         // update right and left
+         if (!updateActivities(colview, oldlb, impliedlb, oldub, impliedub,
+                               activities, lhs, rhs, trail, drift))
+            return false;
+
          changedCols.push_back(col);
       }
       else if (impliedlb > lb[col] + 1e-6 && implbfinite)
       {
          auto colview = problem.getCol(col);
+         double oldlb = lb[col];
+
+         if (trail)
+            trail->pushBounds(col, oldlb, ub[col]);
+
+         lb[col] = impliedlb;
+
          // update right and left
          if (!updateActivities<ChangedBound::LOWER>(
-                 colview, lb[col], impliedlb, activities, lhs, rhs))
+                 colview, oldlb, impliedlb, activities, lhs, rhs, trail,
+                 drift))
             return false;
 
-         lb[col] = impliedlb;
          changedCols.push_back(col);
       }
       else if (impliedub < ub[col] - 1e-6 && impubfinite)
       {
          auto colview = problem.getCol(col);
+         double oldub = ub[col];
+
+         if (trail)
+            trail->pushBounds(col, lb[col], oldub);
+
+         ub[col] = impliedub;
+
          // update right and left
          if (!updateActivities<ChangedBound::UPPER>(
-                 colview, ub[col], impliedub, activities, lhs, rhs))
+                 colview, oldub, impliedub, activities, lhs, rhs, trail,
+                 drift))
             return false;
 
-         ub[col] = impliedub;
          changedCols.push_back(col);
       }
    }
@@ -290,40 +353,111 @@ propagateRow(const MIP& problem, int row,
    return true;
 }
 
-int
-propagate(const MIP& mip, std::vector<double>& lb, std::vector<double>& ub,
-          std::vector<Activity>& activities, int changedcol, double oldlb,
-          double oldub)
+// buffers reused by the propagation calls of a thread, the rows waiting in
+// the queue are flagged so that a row is queued at most once at a time
+struct PropagationScratch
 {
-   int ncols = mip.getNCols();
-
+   std::vector<int> queue;
+   std::vector<uint8_t> queued;
    std::vector<int> changedCols;
-   changedCols.reserve(ncols);
+};
+
+static thread_local PropagationScratch scratch;
+
+// propagates the rows of the changed column until no bound changes, the
+// rows of each column changed on the way are queued again
+static bool
+propagateQueue(const MIP& mip, std::vector<double>& lb,
+               std::vector<double>& ub, std::vector<Activity>& activities,
+               int changedcol, double oldlb, double oldub,
+               std::vector<int>& changedCols, PropagationTrail* trail,
+               const PropagationLimits& limits, ActivityDrift* drift)
+{
+   auto& queue = scratch.queue;
+   auto& queued = scratch.queued;
+
+   assert(queue.empty());
+   assert(!drift || drift->tracks(lb, ub));
+   if (queued.size() < static_cast<size_t>(mip.getNRows()))
+      queued.resize(mip.getNRows(), false);
 
    changedCols.push_back(changedcol);
 
+   if (trail)
+      trail->pushBounds(changedcol, oldlb, oldub);
+
    if (!updateActivities(mip.getCol(changedcol), oldlb, lb[changedcol],
                          oldub, ub[changedcol], activities, mip.getLHS(),
-                         mip.getRHS()))
+                         mip.getRHS(), trail, drift))
       return false;
 
-   for (size_t i = 0; i < changedCols.size(); ++i)
-   {
-      const int col = changedCols[i];
-
-      auto [colcoefs, rowindices, colsize] = mip.getCol(col);
+   auto queueRows = [&](int col) {
+      auto [colcoefs, colindices, colsize] = mip.getCol(col);
 
       for (int j = 0; j < colsize; ++j)
       {
-         const int row = rowindices[j];
+         const int row = colindices[j];
+         if (!queued[row])
+         {
+            queued[row] = true;
+            queue.push_back(row);
+         }
+      }
+   };
+
+   queueRows(changedcol);
+
+   bool feasible = true;
+   size_t head = 0;
+   size_t firstChange = changedCols.size();
+   int nrows = 0;
+
+   while (head < queue.size() && nrows < limits.maxrows &&
+          static_cast<int>(changedCols.size()) < limits.maxchanges)
+   {
+      const int row = queue[head++];
+      queued[row] = false;
+      ++nrows;
+
+      // the bounds are consistent with the activities between two rows
+      if (drift && drift->drifted(row, activities[row]))
+      {
+         if (trail)
+            trail->pushActivity(row, activities[row], drift);
 
-         // propagate row
-         if (!propagateRow(mip, row, activities, lb, ub, changedCols))
-            return 0;
+         activities[row] = drift->recompute(row);
       }
+
+      if (!propagateRow(mip, row, activities, lb, ub, changedCols, trail,
+                        drift))
+      {
+         feasible = false;
+         break;
+      }
+
+      for (; firstChange < changedCols.size(); ++firstChange)
+         queueRows(changedCols[firstChange]);
    }
 
-   return 1;
+   // the rows left over when a limit is reached or the propagation fails
+   for (; head < queue.size(); ++head)
+      queued[queue[head]] = false;
+   queue.clear();
+
+   return feasible;
+}
+
+int
+propagate(const MIP& mip, std::vector<double>& lb, std::vector<double>& ub,
+          std::vector<Activity>& activities, int changedcol, double oldlb,
+          double oldub, const PropagationLimits& limits,
+          ActivityDrift* drift)
+{
+   auto& changedCols = scratch.changedCols;
+   changedCols.clear();
+
+   return propagateQueue(mip, lb, ub, activities, changedcol, oldlb, oldub,
+                         changedCols, nullptr, limits, drift);
 }
 
 bool
@@ -331,34 +465,13 @@ propagate_get_changed_cols(const MIP& mip, std::vector<double>& lb,
                            std::vector<double>& ub,
                            std::vector<Activity>& activities,
                            int changedcol, double oldlb, double oldub,
-                           std::vector<int>& changedCols)
+                           std::vector<int>& changedCols,
+                           PropagationTrail* trail,
+                           const PropagationLimits& limits,
+                           ActivityDrift* drift)
 {
    assert(changedCols.empty());
-   int ncols = mip.getNCols();
-
-   changedCols.reserve(ncols);
-
-   changedCols.push_back(changedcol);
-
-   if (!updateActivities(mip.getCol(changedcol), oldlb, lb[changedcol],
-                         oldub, ub[changedcol], activities, mip.getLHS(),
-                         mip.getRHS()))
-      return false;
-
-   for (size_t i = 0; i < changedCols.size(); ++i)
-   {
-      const int col = changedCols[i];
 
-      auto [colcoefs, colindices, colsize] = mip.getCol(col);
-
-      for (int j = 0; j < colsize; ++j)
-      {
-         const int row = colindices[j];
-
-         // propagate row
-         if (!propagateRow(mip, row, activities, lb, ub, changedCols))
-            return false;
-      }
-   }
-   return true;
+   return propagateQueue(mip, lb, ub, activities, changedcol, oldlb, oldub,
+                         changedCols, trail, limits, drift);
 }
@@ -4,17 +4,178 @@
 #include "Common.h"
 #include "MIP.h"
 
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// counts the incremental updates of each row activity since it was last
+// computed from scratch, the rounding error grows with the number and the
+// size of the updates. Propagation recomputes a drifted row from the
+// bounds before propagating it, and before declaring it infeasible.
+// The tracker refers to the bounds the activities are computed from, they
+// must be the bounds given to the propagation.
+class ActivityDrift
+{
+ public:
+   ActivityDrift(const MIP& _mip, const std::vector<double>& _lb,
+                 const std::vector<double>& _ub)
+       : mip(_mip), lb(_lb), ub(_ub), nupdates(_mip.getNRows(), 0),
+         magnitude(_mip.getNRows(), 0.0)
+   {
+   }
+
+   bool tracks(const std::vector<double>& _lb,
+               const std::vector<double>& _ub) const
+   {
+      return &lb == &_lb && &ub == &_ub;
+   }
+
+   void record(int row, double change)
+   {
+      ++nupdates[row];
+      magnitude[row] += std::fabs(change);
+   }
+
+   bool drifted(int row, const Activity& activity) const
+   {
+      double scale = 1.0 + std::max(std::fabs(activity.min),
+                                    std::fabs(activity.max));
+      return nupdates[row] >= max_updates ||
+             magnitude[row] > max_magnitude * scale;
+   }
+
+   // the activity of the row from the current bounds
+   Activity recompute(int row)
+   {
+      nupdates[row] = 0;
+      magnitude[row] = 0.0;
+
+      return computeActivity(mip, row, lb, ub);
+   }
+
+   // updates of a row since its last recompute
+   struct State
+   {
+      int nupdates = 0;
+      double magnitude = 0.0;
+   };
+
+   State getState(int row) const { return {nupdates[row], magnitude[row]}; }
+
+   void setState(int row, State state)
+   {
+      nupdates[row] = state.nupdates;
+      magnitude[row] = state.magnitude;
+   }
+
+   // the activities were computed from scratch
+   void clear()
+   {
+      std::fill(nupdates.begin(), nupdates.end(), 0);
+      std::fill(magnitude.begin(), magnitude.end(), 0.0);
+   }
+
+ private:
+   static constexpr int max_updates = 1000;
+   // the error is about the machine epsilon times the magnitude
+   static constexpr double max_magnitude = 1e6;
+
+   const MIP& mip;
+   const std::vector<double>& lb;
+   const std::vector<double>& ub;
+
+   std::vector<int> nupdates;
+   std::vector<double> magnitude;
+};
+
+// the bounds and activities overwritten by propagation, undo() restores
+// them in reverse order so the cost is linear in the number of changes
+class PropagationTrail
+{
+ public:
+   void pushBounds(int col, double lb, double ub)
+   {
+      bounds.emplace_back(col, lb, ub);
+   }
+
+   // the drift state of the row is saved with its activity
+   void pushActivity(int row, const Activity& activity,
+                     const ActivityDrift* drift)
+   {
+      activities.push_back({row, activity,
+                            drift ? drift->getState(row)
+                                  : ActivityDrift::State()});
+   }
+
+   // the drift states are restored with the activities if a tracker is
+   // given, it must be the one given to the propagation
+   void undo(std::vector<double>& lb, std::vector<double>& ub,
+             std::vector<Activity>& rowactivities,
+             ActivityDrift* drift = nullptr)
+   {
+      for (auto it = bounds.rbegin(); it != bounds.rend(); ++it)
+      {
+         auto [col, collb, colub] = *it;
+         lb[col] = collb;
+         ub[col] = colub;
+      }
+
+      for (auto it = activities.rbegin(); it != activities.rend(); ++it)
+      {
+         rowactivities[it->row] = it->activity;
+         if (drift)
+            drift->setState(it->row, it->drift);
+      }
+
+      clear();
+   }
+
+   void clear()
+   {
+      bounds.clear();
+      activities.clear();
+   }
+
+   bool empty() const { return bounds.empty() && activities.empty(); }
+
+ private:
+   struct ActivityChange
+   {
+      int row;
+      Activity activity;
+      ActivityDrift::State drift;
+   };
+
+   std::vector<std::tuple<int, double, double>> bounds;
+   std::vector<ActivityChange> activities;
+};
+
+// stops a propagation call early, the bounds deduced so far are kept
+struct PropagationLimits
+{
+   // rows taken from the queue
+   int maxrows = std::numeric_limits<int>::max();
+   // entries of the changed columns, the propagated column included
+   int maxchanges = std::numeric_limits<int>::max();
+};
+
 int
 propagate(const MIP& problem, std::vector<double>& lb,
           std::vector<double>& ub, std::vector<Activity>& activities,
-          int col, double oldlb, double oldub);
+          int col, double oldlb, double oldub,
+          const PropagationLimits& limits = {},
+          ActivityDrift* drift = nullptr);
 
 bool
 updateActivities(VectorView colview, double oldlb, double newlb,
                  double oldub, double newub,
                  std::vector<Activity>& activities,
                  const std::vector<double>& lhs,
-                 const std::vector<double>& rhs) noexcept;
+                 const std::vector<double>& rhs,
+                 PropagationTrail* trail = nullptr,
+                 ActivityDrift* drift = nullptr) noexcept;
 
 enum class ChangedBound
 {
@@ -27,12 +188,19 @@ bool
 updateActivities(VectorView colview, double oldb, double newb,
                  std::vector<Activity>& activities,
                  const std::vector<double>& lhs,
-                 const std::vector<double>& rhs) noexcept;
+                 const std::vector<double>& rhs,
+                 PropagationTrail* trail = nullptr,
+                 ActivityDrift* drift = nullptr) noexcept;
 
+// the changed columns are appended to the buffer, if a trail is given the
+// previous bounds and activities are pushed on it before being changed
 bool
 propagate_get_changed_cols(const MIP& mip, std::vector<double>& lb,
                            std::vector<double>& ub,
                            std::vector<Activity>& activities,
                            int changedcol, double oldlb, double oldub,
-                           std::vector<int>& buffer);
+                           std::vector<int>& buffer,
+                           PropagationTrail* trail = nullptr,
+                           const PropagationLimits& limits = {},
+                           ActivityDrift* drift = nullptr);
 #endif
@@ -1,4 +1,5 @@
 #include "SparseMatrix.h"
+#include "ska/Hash.hpp"
 
 SparseMatrix::SparseMatrix(SparseMatrix&& other) noexcept
 {
@@ -8,6 +9,11 @@ SparseMatrix::SparseMatrix(SparseMatrix&& other) noexcept
    coefficients = std::move(other.coefficients);
    indices = std::move(other.indices);
    rowStart = std::move(other.rowStart);
+
+   storage = other.storage;
+   floatCoefs = std::move(other.floatCoefs);
+   codes = std::move(other.codes);
+   dictionary = std::move(other.dictionary);
 }
 
 SparseMatrix&
@@ -20,5 +26,94 @@ SparseMatrix::operator=(SparseMatrix&& other) noexcept
    indices = std::move(other.indices);
    rowStart = std::move(other.rowStart);
 
+   storage = other.storage;
+   floatCoefs = std::move(other.floatCoefs);
+   codes = std::move(other.codes);
+   dictionary = std::move(other.dictionary);
+
    return *this;
 }
+
+void
+SparseMatrix::compress()
+{
+   if (storage != DOUBLE_COEFS)
+      return;
+
+   constexpr size_t max_codes = 1 << 8;
+
+   // code the values while there are few distinct ones
+   HashMap<double, uint8_t> valueCodes;
+   std::vector<uint8_t> newCodes(coefficients.size());
+   std::vector<double> values;
+   bool coded = true;
+
+   for (size_t i = 0; i < coefficients.size(); ++i)
+   {
+      auto iter = valueCodes.find(coefficients[i]);
+      if (iter != valueCodes.end())
+      {
+         newCodes[i] = iter->second;
+         continue;
+      }
+
+      if (values.size() == max_codes)
+      {
+         coded = false;
+         break;
+      }
+
+      newCodes[i] = values.size();
+      valueCodes.emplace(coefficients[i], newCodes[i]);
+      values.push_back(coefficients[i]);
+   }
+
+   if (coded)
+   {
+      codes = std::move(newCodes);
+      dictionary = std::move(values);
+      storage = CODED_COEFS;
+   }
+   else if (std::all_of(coefficients.begin(), coefficients.end(),
+                        [](double coef) {
+                           return static_cast<float>(coef) == coef;
+                        }))
+   {
+      floatCoefs.assign(coefficients.begin(), coefficients.end());
+      storage = FLOAT_COEFS;
+   }
+   else
+      return;
+
+   std::vector<double>().swap(coefficients);
+}
+
+CoefArray
+SparseMatrix::getCoefs(int start) const
+{
+   switch (storage)
+   {
+   case FLOAT_COEFS:
+      return CoefArray(floatCoefs.data() + start);
+   case CODED_COEFS:
+      return CoefArray(codes.data() + start, dictionary.data());
+   case DOUBLE_COEFS:
+      break;
+   }
+
+   return CoefArray(coefficients.data() + start);
+}
+
+std::vector<double>
+SparseMatrix::getCoefficients() const
+{
+   if (storage == DOUBLE_COEFS)
+      return coefficients;
+
+   CoefArray coefs = getCoefs(0);
+   std::vector<double> result(indices.size());
+   for (size_t i = 0; i < result.size(); ++i)
+      result[i] = coefs[i];
+
+   return result;
+}
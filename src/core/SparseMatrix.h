@@ -3,9 +3,49 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
+// storage of the coefficients, compress() picks the smallest one that
+// represents every coefficient exactly
+enum CoefStorage : uint8_t
+{
+   DOUBLE_COEFS,
+   // 32-bit floats
+   FLOAT_COEFS,
+   // one byte per entry into a dictionary of the distinct values, 0/+-1
+   // matrices need a dictionary of two values
+   CODED_COEFS,
+};
+
+// read-only access to the coefficients whatever their storage
+struct CoefArray
+{
+   CoefArray(const double* _values) : values(_values) {}
+
+   CoefArray(const float* _floats) : floats(_floats) {}
+
+   CoefArray(const uint8_t* _codes, const double* _dictionary)
+       : codes(_codes), dictionary(_dictionary)
+   {
+   }
+
+   double operator[](int i) const
+   {
+      if (codes)
+         return dictionary[codes[i]];
+      if (floats)
+         return floats[i];
+      return values[i];
+   }
+
+   const double* values = nullptr;
+   const float* floats = nullptr;
+   const uint8_t* codes = nullptr;
+   const double* dictionary = nullptr;
+};
+
 struct SparseMatrix
 {
    SparseMatrix() = default;
@@ -18,11 +58,26 @@ struct SparseMatrix
    SparseMatrix& operator=(SparseMatrix&) = default;
 #endif
 
+   // moves the coefficients to the smallest exact storage
+   void compress();
+
+   // the coefficients of the entries from start on
+   CoefArray getCoefs(int start) const;
+
+   // the coefficients as doubles whatever the storage
+   std::vector<double> getCoefficients() const;
+
    int ncols;
    int nrows;
+   // only filled with DOUBLE_COEFS
    std::vector<double> coefficients;
    std::vector<int> indices;
    std::vector<int> rowStart;
+
+   CoefStorage storage = DOUBLE_COEFS;
+   std::vector<float> floatCoefs;
+   std::vector<uint8_t> codes;
+   std::vector<double> dictionary;
 };
 
 #endif
@@ -4,6 +4,11 @@
 #include <tbb/tick_count.h>
 #include <tbb/atomic.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
 struct Timer
 {
    using time_point = tbb::tick_count;
@@ -13,19 +18,107 @@ struct Timer
    static double seconds(time_point t1, time_point t0) {return (t1 - t0).seconds();}
 };
 
-class TimeLimit
+// stops the heuristics and the lp solves of a search, either when it is
+// cancelled or when its deadline passes
+// copies share the same state, cancelling one cancels all of them, a
+// child token is also cancelled with its parent
+class CancellationToken
 {
  public:
-   TimeLimit(Timer::time_point t, int l) : start(t), limit(l) {}
+   CancellationToken() : state(std::make_shared<State>()) {}
+
+   // token with its own deadline, seconds after t, that is cancelled
+   // when this one is
+   CancellationToken child(Timer::time_point t, double seconds) const
+   {
+      CancellationToken token;
+      token.state->parent = state;
+      token.setDeadline(t, seconds);
+      return token;
+   }
+
+   // the deadline is set before the token is shared
+   void setDeadline(Timer::time_point t, double seconds)
+   {
+      state->start = t;
+      state->deadline = seconds;
+   }
+
+   void cancel()
+   {
+      state->cancelled.store(true, std::memory_order_relaxed);
+   }
 
-   bool reached(Timer::time_point t) const
+   bool isCancelled(Timer::time_point t) const
    {
-      return static_cast<int>(Timer::seconds(t, start)) > limit;
+      for (const State* s = state.get(); s; s = s->parent.get())
+      {
+         if (s->cancelled.load(std::memory_order_relaxed) ||
+             Timer::seconds(t, s->start) >= s->deadline)
+            return true;
+      }
+
+      return false;
    }
 
+   bool isCancelled() const { return isCancelled(Timer::now()); }
+
+   // seconds left before the nearest deadline, 0 if cancelled and
+   // infinity without deadline
+   double remaining(Timer::time_point t) const
+   {
+      double left = std::numeric_limits<double>::infinity();
+
+      for (const State* s = state.get(); s; s = s->parent.get())
+      {
+         if (s->cancelled.load(std::memory_order_relaxed))
+            return 0.0;
+
+         left = std::min(left, s->deadline - Timer::seconds(t, s->start));
+      }
+
+      return std::max(0.0, left);
+   }
+
+   double remaining() const { return remaining(Timer::now()); }
+
+ private:
+   struct State
+   {
+      std::atomic<bool> cancelled{false};
+      Timer::time_point start = Timer::now();
+      double deadline = std::numeric_limits<double>::infinity();
+      std::shared_ptr<const State> parent;
+   };
+
+   std::shared_ptr<State> state;
+};
+
+// time limit in seconds of a search or of one of its phases, it is also
+// reached when the token it derives from is cancelled
+// checking it reads the monotonic clock once, cheap enough for inner
+// loops
+class TimeLimit
+{
+ public:
+   TimeLimit(Timer::time_point t, double seconds,
+             const CancellationToken& parent = CancellationToken())
+       : token(parent.child(t, seconds))
+   {
+   }
+
+   bool reached(Timer::time_point t) const { return token.isCancelled(t); }
+
+   bool reached() const { return token.isCancelled(); }
+
+   // seconds left, 0 once the limit is reached
+   double remaining() const { return token.remaining(); }
+
+   // passed to the lp solves
+   const CancellationToken& getToken() const { return token; }
+
  private:
-   Timer::time_point start;
-   int limit;
+   CancellationToken token;
 };
 
 #endif
@@ -7,8 +7,8 @@
 #ifdef CONCERT_CPLEX_FOUND
 
 CPXSolver::CPXSolver(const MIP& mip)
-    : model(env), variables(env), constraints(env), ncols(mip.getNCols()),
-      nrows(mip.getNRows())
+    : LPSolver(mip), model(env), variables(env), constraints(env),
+      objcoefs(mip.getObj()), ncols(mip.getNCols()), nrows(mip.getNRows())
 {
    IloNumExpr objExpr(env);
 
@@ -21,7 +21,6 @@ CPXSolver::CPXSolver(const MIP& mip)
    // add variables to the model and build the objective expression
    for (int var = 0; var < mip.getNCols(); ++var)
    {
-      assert(static_cast<size_t>(var) < mip.getVarNames().size());
       assert(static_cast<size_t>(var) < obj.size());
 
       variables.add(IloNumVar(env, lb[var], ub[var],
@@ -52,17 +51,6 @@ CPXSolver::CPXSolver(const MIP& mip)
 
    model.add(constraints);
 
-   int id = 0;
-   for (IloIterator<IloRange> it(env); it.ok(); ++it)
-   {
-      IloRange range = *it;
-      const char* name = range.getName();
-      assert(name && std::strlen(name) > 1);
-      int row = std::atoi(name + 1);
-      exidTorowid.emplace(id, row);
-      ++id;
-   }
-
    try
    {
       cplex = model;
@@ -75,43 +63,21 @@ CPXSolver::CPXSolver(const MIP& mip)
    }
 }
 
-CPXSolver::CPXSolver(const CPXSolver& cpxsolver)
-    : env(), model(env), objective(env), variables(env), constraints(env),
-      cplex(env), exidTorowid(cpxsolver.exidTorowid),
-      ncols(cpxsolver.ncols), nrows(cpxsolver.nrows)
+LPResult
+CPXSolver::solve(Algorithm alg, const CancellationToken& token)
 {
-   model = cpxsolver.model.getClone(env);
-
-   variables.setSize(ncols);
-   for (IloIterator<IloNumVar> it(env); it.ok(); ++it)
-   {
-      IloNumVar var = *it;
-      const char* name = var.getName();
-      assert(name && std::strlen(name) > 1);
-      int col = std::atoi(name + 1);
-      variables[col] = var;
-   }
-   assert(variables.getSize() == ncols);
+   LPResult result;
 
-   constraints.setSize(nrows);
-   int id = 0;
-   for (IloIterator<IloRange> it(env); it.ok(); ++it)
+   double remaining = token.remaining();
+   if (remaining <= 0.0)
    {
-      IloRange range = *it;
-      constraints[exidTorowid[id]] = range;
-      ++id;
+      result.status = LPResult::OTHER;
+      return result;
    }
 
-   for (IloIterator<IloObjective> it(env); it.ok(); ++it)
-      objective = *it;
+   // the largest time limit accepted by cplex means no limit
+   cplex.setParam(IloCplex::Param::TimeLimit, std::min(remaining, 1e75));
 
-   assert(constraints.getSize() == nrows);
-   cplex.extract(model);
-}
-
-LPResult
-CPXSolver::solve(Algorithm alg)
-{
    cplex.setOut(env.getNullStream());
    cplex.setError(env.getNullStream());
    cplex.setWarning(env.getNullStream());
@@ -130,7 +96,6 @@ CPXSolver::solve(Algorithm alg)
 
    cplex.solve();
 
-   LPResult result;
    auto cpxstatus = cplex.getStatus();
 
    if (cpxstatus == IloAlgorithm::Optimal)
@@ -171,13 +136,13 @@ CPXSolver::solve(Algorithm alg)
 }
 
 std::unique_ptr<LPSolver>
-CPXSolver::makeCopy() const
+CPXSolver::makeNew(const MIP& mip) const
 {
-   return std::make_unique<CPXSolver>(*this);
+   return std::make_unique<CPXSolver>(mip);
 }
 
 void
-CPXSolver::changeBounds(int column, double lb, double ub)
+CPXSolver::doChangeBounds(int column, double lb, double ub)
 {
    variables[column].setBounds(lb, ub);
    assert(variables[column].getLb() == lb);
@@ -185,14 +150,158 @@ CPXSolver::changeBounds(int column, double lb, double ub)
 }
 
 void
-CPXSolver::changeObjective(int column, double coef)
+CPXSolver::doChangeObjective(int column, double coef)
 {
    objective.setLinearCoef(variables[column], coef);
+   objcoefs[column] = coef;
+}
+
+void
+CPXSolver::doChangeObjective(const std::vector<int>& columns,
+                             const std::vector<double>& coefs)
+{
+   IloNumVarArray vars(env, columns.size());
+   IloNumArray ilocoefs(env, columns.size());
+
+   for (size_t i = 0; i < columns.size(); ++i)
+   {
+      vars[i] = variables[columns[i]];
+      ilocoefs[i] = coefs[columns[i]];
+      objcoefs[columns[i]] = coefs[columns[i]];
+   }
+
+   objective.setLinearCoefs(vars, ilocoefs);
+
+   vars.end();
+   ilocoefs.end();
+}
+
+void
+CPXSolver::doChangeBounds(const std::vector<int>& columns,
+                          const std::vector<double>& lb,
+                          const std::vector<double>& ub)
+{
+   IloNumVarArray vars(env, columns.size());
+   IloNumArray ilolb(env, columns.size());
+   IloNumArray iloub(env, columns.size());
+
+   for (size_t i = 0; i < columns.size(); ++i)
+   {
+      vars[i] = variables[columns[i]];
+      ilolb[i] = lb[columns[i]];
+      iloub[i] = ub[columns[i]];
+   }
+
+   vars.setBounds(ilolb, iloub);
+
+   vars.end();
+   ilolb.end();
+   iloub.end();
+}
+
+std::pair<double, double>
+CPXSolver::getBounds(int column) const
+{
+   return {variables[column].getLb(), variables[column].getUb()};
+}
+
+double
+CPXSolver::getObjective(int column) const
+{
+   return objcoefs[column];
+}
+
+static LPBasis::Status
+fromCPXStatus(IloCplex::BasisStatus stat)
+{
+   switch (stat)
+   {
+   case IloCplex::Basic:
+      return LPBasis::BASIC;
+   case IloCplex::AtLower:
+      return LPBasis::AT_LOWER;
+   case IloCplex::AtUpper:
+      return LPBasis::AT_UPPER;
+   case IloCplex::FreeOrSuperbasic:
+      return LPBasis::AT_ZERO;
+   default:
+      assert(0);
+      return LPBasis::BASIC;
+   }
+}
+
+static IloCplex::BasisStatus
+toCPXStatus(LPBasis::Status stat)
+{
+   switch (stat)
+   {
+   case LPBasis::BASIC:
+      return IloCplex::Basic;
+   // cplex has no status for the fixed variables
+   case LPBasis::AT_LOWER:
+   case LPBasis::FIXED:
+      return IloCplex::AtLower;
+   case LPBasis::AT_UPPER:
+      return IloCplex::AtUpper;
+   case LPBasis::AT_ZERO:
+      return IloCplex::FreeOrSuperbasic;
+   }
+
+   assert(0);
+   return IloCplex::Basic;
+}
+
+LPBasis
+CPXSolver::getBasis() const
+{
+   LPBasis basis;
+
+   IloCplex::BasisStatusArray colstat(env);
+   IloCplex::BasisStatusArray rowstat(env);
+
+   // cplex throws if there is no basis
+   try
+   {
+      cplex.getBasisStatuses(colstat, variables, rowstat, constraints);
+   }
+   catch (IloException&)
+   {
+      return basis;
+   }
+
+   basis.colStatus.resize(ncols);
+   basis.rowStatus.resize(nrows);
+
+   for (int col = 0; col < ncols; ++col)
+      basis.colStatus[col] = fromCPXStatus(colstat[col]);
+
+   for (int row = 0; row < nrows; ++row)
+      basis.rowStatus[row] = fromCPXStatus(rowstat[row]);
+
+   return basis;
+}
+
+void
+CPXSolver::setBasis(const LPBasis& basis)
+{
+   assert(basis.colStatus.size() == static_cast<size_t>(ncols));
+   assert(basis.rowStatus.size() == static_cast<size_t>(nrows));
+
+   IloCplex::BasisStatusArray colstat(env, ncols);
+   IloCplex::BasisStatusArray rowstat(env, nrows);
+
+   for (int col = 0; col < ncols; ++col)
+      colstat[col] = toCPXStatus(basis.colStatus[col]);
+
+   for (int row = 0; row < nrows; ++row)
+      rowstat[row] = toCPXStatus(basis.rowStatus[row]);
+
+   cplex.setBasisStatuses(colstat, variables, rowstat, constraints);
 }
 
 void
-CPXSolver::changeBounds(const std::vector<double>& lb,
-                        const std::vector<double>& ub)
+CPXSolver::doChangeBounds(const std::vector<double>& lb,
+                          const std::vector<double>& ub)
 {
    IloNumArray ilolb(env, ncols);
    IloNumArray iloub(env, ncols);
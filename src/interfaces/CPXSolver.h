@@ -12,22 +12,34 @@ class CPXSolver : public LPSolver
  public:
    CPXSolver(const MIP&);
 
-   CPXSolver(const CPXSolver&);
-
    ~CPXSolver() override;
 
-   LPResult solve(Algorithm) override;
-
-   std::unique_ptr<LPSolver> makeCopy() const override;
+   LPResult solve(Algorithm, const CancellationToken&) override;
 
-   void changeBounds(int column, double lb, double ub) override;
+   std::unique_ptr<LPSolver> makeNew(const MIP&) const override;
 
-   void changeBounds(const std::vector<double>&,
-                     const std::vector<double>&) override;
+   LPBasis getBasis() const override;
 
-   void changeObjective(int, double) override;
+   void setBasis(const LPBasis&) override;
 
  private:
+   void doChangeBounds(int column, double lb, double ub) override;
+
+   void doChangeBounds(const std::vector<double>&,
+                       const std::vector<double>&) override;
+
+   void doChangeBounds(const std::vector<int>&, const std::vector<double>&,
+                       const std::vector<double>&) override;
+
+   void doChangeObjective(int, double) override;
+
+   void doChangeObjective(const std::vector<int>&,
+                          const std::vector<double>&) override;
+
+   std::pair<double, double> getBounds(int column) const override;
+
+   double getObjective(int column) const override;
+
    IloEnv env;
    IloModel model;
    IloObjective objective;
@@ -35,11 +47,8 @@ class CPXSolver : public LPSolver
    IloRangeArray constraints;
    IloCplex cplex;
 
-   // mapping of the order in which the IloRange are obtained
-   // when iterating with IloIterator<IloRange> to the row number in the
-   // problem
-   // used to copy a model and keep the correct order in the IloRangeArray
-   HashMap<int, int> exidTorowid;
+   // coefficients of the objective, concert has no getter for them
+   std::vector<double> objcoefs;
 
    int ncols;
    int nrows;
@@ -1,11 +1,13 @@
 #include "GLPKSolver.h"
 #include "core/Common.h"
 #include <algorithm>
+#include <limits>
 #include <numeric>
 
 #ifdef GLPK_FOUND
 GLPKSolver::GLPKSolver(const MIP& mip)
-    : problem(nullptr), ncols(mip.getNCols()), nrows(mip.getNRows())
+    : LPSolver(mip), problem(nullptr), ncols(mip.getNCols()),
+      nrows(mip.getNRows())
 {
    const auto& lb = mip.getLB();
    const auto& ub = mip.getUB();
@@ -23,6 +25,7 @@ GLPKSolver::GLPKSolver(const MIP& mip)
 
    std::vector<int> ind_buffer;
    ind_buffer.reserve(ncols);
+   std::vector<double> coef_buffer;
 
    for (int col = 0; col < ncols; ++col)
    {
@@ -66,18 +69,36 @@ GLPKSolver::GLPKSolver(const MIP& mip)
       std::transform(rowview.indices, rowview.indices + rowview.size,
                      ind_buffer.begin(), [&](int id) { return ++id; });
 
+      // glpk needs the coefficients as doubles
+      coef_buffer.resize(rowview.size);
+      for (int id = 0; id < rowview.size; ++id)
+         coef_buffer[id] = rowview.coefs[id];
+
       glp_set_mat_row(problem, row + 1, rowview.size,
-                      ind_buffer.data() - 1, rowview.coefs - 1);
+                      ind_buffer.data() - 1, coef_buffer.data() - 1);
    }
    glp_term_out(GLP_OFF);
 }
 
 LPResult
-GLPKSolver::solve(Algorithm alg)
+GLPKSolver::solve(Algorithm alg, const CancellationToken& token)
 {
+   LPResult result;
+
+   double remaining = token.remaining();
+   if (remaining <= 0.0)
+   {
+      result.status = LPResult::OTHER;
+      return result;
+   }
+
    glp_smcp params;
    glp_init_smcp(&params);
 
+   // glpk takes the time limit in milliseconds
+   if (remaining * 1000.0 < std::numeric_limits<int>::max())
+      params.tm_lim = std::max(1, static_cast<int>(remaining * 1000.0));
+
    switch (alg)
    {
    case Algorithm::PRIMAL:
@@ -92,7 +113,6 @@ GLPKSolver::solve(Algorithm alg)
 
    int ret = glp_simplex(problem, &params);
 
-   LPResult result;
    if (!ret)
    {
       int st = glp_get_status(problem);
@@ -132,25 +152,16 @@ GLPKSolver::solve(Algorithm alg)
    return result;
 }
 
-GLPKSolver::GLPKSolver(const GLPKSolver& glpksolver)
-    : problem(nullptr), ncols(glpksolver.ncols), nrows(glpksolver.nrows)
-{
-   problem = glp_create_prob();
-   glp_copy_prob(problem, glpksolver.problem, GLP_OFF);
-   glp_term_out(GLP_OFF);
-   assert(problem);
-}
-
 std::unique_ptr<LPSolver>
-GLPKSolver::makeCopy() const
+GLPKSolver::makeNew(const MIP& mip) const
 {
-   return std::make_unique<GLPKSolver>(*this);
+   return std::make_unique<GLPKSolver>(mip);
 }
 
 GLPKSolver::~GLPKSolver() { glp_delete_prob(problem); }
 
 void
-GLPKSolver::changeBounds(int column, double lb, double ub)
+GLPKSolver::doChangeBounds(int column, double lb, double ub)
 {
    constexpr double inf = std::numeric_limits<double>::infinity();
 
@@ -170,8 +181,8 @@ GLPKSolver::changeBounds(int column, double lb, double ub)
 }
 
 void
-GLPKSolver::changeBounds(const std::vector<double>& lb,
-                         const std::vector<double>& ub)
+GLPKSolver::doChangeBounds(const std::vector<double>& lb,
+                           const std::vector<double>& ub)
 {
    constexpr double inf = std::numeric_limits<double>::infinity();
 
@@ -193,10 +204,134 @@ GLPKSolver::changeBounds(const std::vector<double>& lb,
    }
 }
 
+// glpk has no call changing several columns at once
+void
+GLPKSolver::doChangeBounds(const std::vector<int>& columns,
+                           const std::vector<double>& lb,
+                           const std::vector<double>& ub)
+{
+   for (int col : columns)
+      doChangeBounds(col, lb[col], ub[col]);
+}
+
 void
-GLPKSolver::changeObjective(int column, double coef)
+GLPKSolver::doChangeObjective(int column, double coef)
 {
    glp_set_obj_coef(problem, column + 1, coef);
 }
 
+void
+GLPKSolver::doChangeObjective(const std::vector<int>& columns,
+                              const std::vector<double>& coefs)
+{
+   for (int col : columns)
+      glp_set_obj_coef(problem, col + 1, coefs[col]);
+}
+
+std::pair<double, double>
+GLPKSolver::getBounds(int column) const
+{
+   constexpr double inf = std::numeric_limits<double>::infinity();
+
+   // glpk returns +-DBL_MAX for the missing bounds
+   switch (glp_get_col_type(problem, column + 1))
+   {
+   case GLP_FR:
+      return {-inf, inf};
+   case GLP_LO:
+      return {glp_get_col_lb(problem, column + 1), inf};
+   case GLP_UP:
+      return {-inf, glp_get_col_ub(problem, column + 1)};
+   default:
+      return {glp_get_col_lb(problem, column + 1),
+              glp_get_col_ub(problem, column + 1)};
+   }
+}
+
+double
+GLPKSolver::getObjective(int column) const
+{
+   return glp_get_obj_coef(problem, column + 1);
+}
+
+static LPBasis::Status
+fromGLPKStatus(int stat)
+{
+   switch (stat)
+   {
+   case GLP_BS:
+      return LPBasis::BASIC;
+   case GLP_NL:
+      return LPBasis::AT_LOWER;
+   case GLP_NU:
+      return LPBasis::AT_UPPER;
+   case GLP_NF:
+      return LPBasis::AT_ZERO;
+   case GLP_NS:
+      return LPBasis::FIXED;
+   default:
+      assert(0);
+      return LPBasis::BASIC;
+   }
+}
+
+static int
+toGLPKStatus(LPBasis::Status stat)
+{
+   switch (stat)
+   {
+   case LPBasis::BASIC:
+      return GLP_BS;
+   case LPBasis::AT_LOWER:
+      return GLP_NL;
+   case LPBasis::AT_UPPER:
+      return GLP_NU;
+   case LPBasis::AT_ZERO:
+      return GLP_NF;
+   case LPBasis::FIXED:
+      return GLP_NS;
+   }
+
+   assert(0);
+   return GLP_BS;
+}
+
+LPBasis
+GLPKSolver::getBasis() const
+{
+   // glpk always has a basis, the initial one has all the rows basic
+   LPBasis basis;
+   basis.colStatus.resize(ncols);
+   basis.rowStatus.resize(nrows);
+
+   for (int col = 0; col < ncols; ++col)
+      basis.colStatus[col] =
+          fromGLPKStatus(glp_get_col_stat(problem, col + 1));
+
+   for (int row = 0; row < nrows; ++row)
+      basis.rowStatus[row] =
+          fromGLPKStatus(glp_get_row_stat(problem, row + 1));
+
+   return basis;
+}
+
+void
+GLPKSolver::setBasis(const LPBasis& basis)
+{
+   assert(basis.colStatus.size() == static_cast<size_t>(ncols));
+   assert(basis.rowStatus.size() == static_cast<size_t>(nrows));
+
+   for (int col = 0; col < ncols; ++col)
+      glp_set_col_stat(problem, col + 1,
+                       toGLPKStatus(basis.colStatus[col]));
+
+   for (int row = 0; row < nrows; ++row)
+      glp_set_row_stat(problem, row + 1,
+                       toGLPKStatus(basis.rowStatus[row]));
+
+   // glp_simplex fails on a singular basis
+   if (glp_factorize(problem) != 0)
+      glp_std_basis(problem);
+}
+
 #endif // GLPK_FOUND
@@ -4,7 +4,7 @@
 #ifdef SOPLEX_FOUND
 
 SPXSolver::SPXSolver(const MIP& mip)
-    : ncols(mip.getNCols()), nrows(mip.getNRows())
+    : LPSolver(mip), ncols(mip.getNCols()), nrows(mip.getNRows())
 {
    using namespace soplex;
 
@@ -52,17 +52,22 @@ SPXSolver::SPXSolver(const MIP& mip)
    mysoplex.setIntParam(SoPlex::VERBOSITY, SoPlex::VERBOSITY_ERROR);
 }
 
-SPXSolver::SPXSolver(const SPXSolver& spxsolver)
-    : mysoplex(spxsolver.mysoplex), ncols(spxsolver.ncols),
-      nrows(spxsolver.nrows)
-{
-}
-
 LPResult
-SPXSolver::solve(Algorithm alg)
+SPXSolver::solve(Algorithm alg, const CancellationToken& token)
 {
    using namespace soplex;
 
+   LPResult result;
+
+   double remaining = token.remaining();
+   if (remaining <= 0.0)
+   {
+      result.status = LPResult::OTHER;
+      return result;
+   }
+
+   mysoplex.setRealParam(SoPlex::TIMELIMIT, std::min(remaining, infinity));
+
    switch (alg)
    {
    case Algorithm::PRIMAL:
@@ -77,7 +82,6 @@ SPXSolver::solve(Algorithm alg)
       assert(0);
    }
 
-   LPResult result;
    SPxSolver::Status stat;
    DVector prim(ncols);
    DVector dual(nrows);
@@ -109,20 +113,20 @@ SPXSolver::solve(Algorithm alg)
 }
 
 std::unique_ptr<LPSolver>
-SPXSolver::makeCopy() const
+SPXSolver::makeNew(const MIP& mip) const
 {
-   return std::make_unique<SPXSolver>(*this);
+   return std::make_unique<SPXSolver>(mip);
 }
 
 void
-SPXSolver::changeBounds(int column, double lb, double ub)
+SPXSolver::doChangeBounds(int column, double lb, double ub)
 {
    mysoplex.changeBoundsReal(column, lb, ub);
 }
 
 void
-SPXSolver::changeBounds(const std::vector<double>& lb,
-                        const std::vector<double>& ub)
+SPXSolver::doChangeBounds(const std::vector<double>& lb,
+                          const std::vector<double>& ub)
 {
    using namespace soplex;
 
@@ -139,9 +143,173 @@ SPXSolver::changeBounds(const std::vector<double>& lb,
 }
 
 void
-SPXSolver::changeObjective(int column, double coef)
+SPXSolver::doChangeBounds(const std::vector<int>& columns,
+                          const std::vector<double>& lb,
+                          const std::vector<double>& ub)
+{
+   using namespace soplex;
+
+   // each call updates the basis and invalidates the solution, the whole
+   // bound vectors are replaced when many columns change
+   if (2 * columns.size() < static_cast<size_t>(ncols))
+   {
+      for (int col : columns)
+         mysoplex.changeBoundsReal(col, lb[col], ub[col]);
+      return;
+   }
+
+   DVector soplb(ncols);
+   DVector sopub(ncols);
+   mysoplex.getLowerReal(soplb);
+   mysoplex.getUpperReal(sopub);
+
+   for (int col : columns)
+   {
+      soplb[col] = lb[col];
+      sopub[col] = ub[col];
+   }
+
+   mysoplex.changeBoundsReal(soplb, sopub);
+}
+
+void
+SPXSolver::doChangeObjective(int column, double coef)
 {
    mysoplex.changeObjReal(column, coef);
 }
 
+void
+SPXSolver::doChangeObjective(const std::vector<int>& columns,
+                             const std::vector<double>& coefs)
+{
+   using namespace soplex;
+
+   if (2 * columns.size() < static_cast<size_t>(ncols))
+   {
+      for (int col : columns)
+         mysoplex.changeObjReal(col, coefs[col]);
+      return;
+   }
+
+   DVector sopobj(ncols);
+   mysoplex.getObjReal(sopobj);
+
+   for (int col : columns)
+      sopobj[col] = coefs[col];
+
+   mysoplex.changeObjReal(sopobj);
+}
+
+std::pair<double, double>
+SPXSolver::getBounds(int column) const
+{
+   using namespace soplex;
+
+   constexpr double myinf = std::numeric_limits<double>::infinity();
+
+   // soplex has its own infinity
+   double lb = mysoplex.lowerReal(column);
+   double ub = mysoplex.upperReal(column);
+
+   return {lb <= -infinity ? -myinf : lb, ub >= infinity ? myinf : ub};
+}
+
+double
+SPXSolver::getObjective(int column) const
+{
+   return mysoplex.objReal(column);
+}
+
+static LPBasis::Status
+fromSPXStatus(soplex::SPxSolver::VarStatus stat)
+{
+   using namespace soplex;
+
+   switch (stat)
+   {
+   case SPxSolver::BASIC:
+      return LPBasis::BASIC;
+   case SPxSolver::ON_LOWER:
+      return LPBasis::AT_LOWER;
+   case SPxSolver::ON_UPPER:
+      return LPBasis::AT_UPPER;
+   case SPxSolver::ZERO:
+      return LPBasis::AT_ZERO;
+   case SPxSolver::FIXED:
+      return LPBasis::FIXED;
+   default:
+      assert(0);
+      return LPBasis::BASIC;
+   }
+}
+
+static soplex::SPxSolver::VarStatus
+toSPXStatus(LPBasis::Status stat)
+{
+   using namespace soplex;
+
+   switch (stat)
+   {
+   case LPBasis::BASIC:
+      return SPxSolver::BASIC;
+   case LPBasis::AT_LOWER:
+      return SPxSolver::ON_LOWER;
+   case LPBasis::AT_UPPER:
+      return SPxSolver::ON_UPPER;
+   case LPBasis::AT_ZERO:
+      return SPxSolver::ZERO;
+   case LPBasis::FIXED:
+      return SPxSolver::FIXED;
+   }
+
+   assert(0);
+   return SPxSolver::BASIC;
+}
+
+LPBasis
+SPXSolver::getBasis() const
+{
+   using namespace soplex;
+
+   LPBasis basis;
+
+   if (!mysoplex.hasBasis())
+      return basis;
+
+   std::vector<SPxSolver::VarStatus> colstat(ncols);
+   std::vector<SPxSolver::VarStatus> rowstat(nrows);
+   mysoplex.getBasis(rowstat.data(), colstat.data());
+
+   basis.colStatus.resize(ncols);
+   basis.rowStatus.resize(nrows);
+
+   for (int col = 0; col < ncols; ++col)
+      basis.colStatus[col] = fromSPXStatus(colstat[col]);
+
+   for (int row = 0; row < nrows; ++row)
+      basis.rowStatus[row] = fromSPXStatus(rowstat[row]);
+
+   return basis;
+}
+
+void
+SPXSolver::setBasis(const LPBasis& basis)
+{
+   using namespace soplex;
+
+   assert(basis.colStatus.size() == static_cast<size_t>(ncols));
+   assert(basis.rowStatus.size() == static_cast<size_t>(nrows));
+
+   std::vector<SPxSolver::VarStatus> colstat(ncols);
+   std::vector<SPxSolver::VarStatus> rowstat(nrows);
+
+   for (int col = 0; col < ncols; ++col)
+      colstat[col] = toSPXStatus(basis.colStatus[col]);
+
+   for (int row = 0; row < nrows; ++row)
+      rowstat[row] = toSPXStatus(basis.rowStatus[row]);
+
+   mysoplex.setBasis(rowstat.data(), colstat.data());
+}
+
 #endif
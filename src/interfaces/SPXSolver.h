@@ -10,22 +10,34 @@ class SPXSolver : public LPSolver
  public:
    SPXSolver(const MIP&);
 
-   SPXSolver(const SPXSolver&);
-
    ~SPXSolver() override = default;
 
-   LPResult solve(Algorithm) override;
-
-   std::unique_ptr<LPSolver> makeCopy() const override;
+   LPResult solve(Algorithm, const CancellationToken&) override;
 
-   void changeBounds(int column, double lb, double ub) override;
+   std::unique_ptr<LPSolver> makeNew(const MIP&) const override;
 
-   void changeBounds(const std::vector<double>&,
-                     const std::vector<double>&) override;
+   LPBasis getBasis() const override;
 
-   void changeObjective(int, double) override;
+   void setBasis(const LPBasis&) override;
 
  private:
+   void doChangeBounds(int column, double lb, double ub) override;
+
+   void doChangeBounds(const std::vector<double>&,
+                       const std::vector<double>&) override;
+
+   void doChangeBounds(const std::vector<int>&, const std::vector<double>&,
+                       const std::vector<double>&) override;
+
+   void doChangeObjective(int, double) override;
+
+   void doChangeObjective(const std::vector<int>&,
+                          const std::vector<double>&) override;
+
+   std::pair<double, double> getBounds(int column) const override;
+
+   double getObjective(int column) const override;
+
    soplex::SoPlex mysoplex;
    int ncols;
    int nrows;
@@ -13,10 +13,14 @@ parseArgs(int argc, char** argv)
 
    ArgInfo arginfo;
 
-   arginfo.timelimit = std::numeric_limits<int>::max();
+   arginfo.timelimit = std::numeric_limits<double>::infinity();
+   arginfo.lplimit = std::numeric_limits<double>::infinity();
+   arginfo.feaslimit = std::numeric_limits<double>::infinity();
+   arginfo.imprlimit = std::numeric_limits<double>::infinity();
    arginfo.nthreads = -1;
    arginfo.probFile = "mip.mps";
    arginfo.writeSol = false;
+   arginfo.readSnapshot = false;
 
 #ifndef NDEBUG
    arginfo.verbosity = 2;
@@ -26,6 +30,14 @@ parseArgs(int argc, char** argv)
        (value("input file", arginfo.probFile),
         option("-l") & value("tlimit", arginfo.timelimit)
                            .doc("time limit in seconds"),
+        option("--lp-limit") & value("lplimit", arginfo.lplimit)
+                                   .doc("time limit of the root lp"),
+        option("--feas-limit") &
+            value("feaslimit", arginfo.feaslimit)
+                .doc("time limit of the feasibility heuristics"),
+        option("--impr-limit") &
+            value("imprlimit", arginfo.imprlimit)
+                .doc("time limit of the improvement heuristics"),
 #ifndef NDEBUG
         option("-v") & value("verbosity", arginfo.verbosity),
 #endif
@@ -36,7 +48,13 @@ parseArgs(int argc, char** argv)
             value("start_sol", arginfo.solutionFile)
                 .doc("path to solution to improve"),
         option("-c", "--config") &
-            value("config", arginfo.configFile).doc("configuration file"));
+            value("config", arginfo.configFile).doc("configuration file"),
+        option("--write-snapshot") &
+            value("snapshot", arginfo.snapshotFile)
+                .doc("write a binary snapshot of the problem"),
+        option("--read-snapshot")
+            .set(arginfo.readSnapshot)
+            .doc("input file is a binary snapshot"));
 
    if (!parse(argc, argv, cli))
    {
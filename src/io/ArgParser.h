@@ -12,11 +12,19 @@ struct ArgInfo
    std::string configFile;
    // input solution
    std::string solutionFile;
+   // binary snapshot of the problem to write
+   std::string snapshotFile;
 
-   int timelimit;
+   // time limits in seconds, of the search and of its phases
+   double timelimit;
+   double lplimit;
+   double feaslimit;
+   double imprlimit;
    int nthreads;
    // write solution to a file
    bool writeSol;
+   // the input file is a binary snapshot
+   bool readSnapshot;
 #ifndef NDEBUG
    // output level
    int verbosity;
@@ -0,0 +1,282 @@
+#include "GPHFormat.h"
+#include "Message.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct SnapshotHeader
+{
+   char magic[8];
+   uint32_t version;
+   // detects snapshots written on a machine with another byte order
+   uint32_t byteorder;
+   Statistics stats;
+   double objoffset;
+};
+
+static constexpr char snapshot_magic[8] = {'G', 'P', 'H', 'S',
+                                           'N', 'A', 'P', '\0'};
+static constexpr uint32_t snapshot_byteorder = 0x01020304;
+static constexpr size_t snapshot_alignment = 8;
+
+static size_t
+padded(size_t size)
+{
+   return (size + snapshot_alignment - 1) / snapshot_alignment *
+          snapshot_alignment;
+}
+
+static void
+writeArray(std::FILE* out, const void* data, size_t size)
+{
+   static const char padding[snapshot_alignment] = {};
+   size_t npadding = padded(size) - size;
+
+   if ((size > 0 && std::fwrite(data, 1, size, out) != size) ||
+       (npadding > 0 &&
+        std::fwrite(padding, 1, npadding, out) != npadding))
+      throw std::runtime_error("unable to write snapshot");
+}
+
+template <typename T>
+static void
+writeVector(std::FILE* out, const std::vector<T>& vec)
+{
+   writeArray(out, vec.data(), vec.size() * sizeof(T));
+}
+
+// the names are stored as an array of offsets followed by the
+// concatenation of the names
+static void
+writeNames(std::FILE* out, const NameTable& names, size_t size)
+{
+   if (names.empty())
+   {
+      writeVector(out, std::vector<uint64_t>(size + 1, 0));
+      return;
+   }
+
+   writeVector(out, names.getOffsets());
+
+   const std::string& chars = names.getChars();
+   writeArray(out, chars.data(), chars.size());
+}
+
+void
+GPHFormat::write(const std::string& file, const MIP& mip)
+{
+   std::FILE* out = std::fopen(file.c_str(), "wb");
+   if (out == nullptr)
+      throw std::runtime_error("unable to open output file");
+
+   SnapshotHeader header;
+   std::memset(static_cast<void*>(&header), 0, sizeof(header));
+   std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+   header.version = version;
+   header.byteorder = snapshot_byteorder;
+   header.stats = mip.stats;
+   header.objoffset = mip.objoffset;
+
+   try
+   {
+      writeArray(out, &header, sizeof(header));
+
+      writeVector(out, mip.objective);
+      writeVector(out, mip.lb);
+      writeVector(out, mip.ub);
+      writeVector(out, mip.lhs);
+      writeVector(out, mip.rhs);
+      writeVector(out, mip.downLocks);
+      writeVector(out, mip.upLocks);
+
+      for (const SparseMatrix* matrix :
+           {&mip.constMatrix, &mip.constMatrixT})
+      {
+         writeVector(out, matrix->getCoefficients());
+         writeVector(out, matrix->indices);
+         writeVector(out, matrix->rowStart);
+      }
+
+      writeNames(out, mip.varNames, mip.stats.ncols);
+      writeNames(out, mip.consNames, mip.stats.nrows);
+   }
+   catch (const std::exception&)
+   {
+      std::fclose(out);
+      throw;
+   }
+
+   if (std::fclose(out) != 0)
+      throw std::runtime_error("unable to write snapshot");
+
+   Message::debug("snapshot written to {}", file);
+}
+
+// read-only mapping of a snapshot file
+struct SnapshotMapping
+{
+   explicit SnapshotMapping(const std::string& file)
+   {
+      int fd = open(file.c_str(), O_RDONLY);
+      if (fd < 0)
+         throw std::runtime_error("unable to open file");
+
+      struct stat filestat;
+      if (fstat(fd, &filestat) != 0 ||
+          static_cast<size_t>(filestat.st_size) < sizeof(SnapshotHeader))
+      {
+         close(fd);
+         throw std::runtime_error("invalid snapshot file");
+      }
+
+      size = filestat.st_size;
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+
+      if (data == MAP_FAILED)
+         throw std::runtime_error("unable to map file");
+
+      madvise(data, size, MADV_SEQUENTIAL);
+   }
+
+   ~SnapshotMapping() { munmap(data, size); }
+
+   const char* begin() const { return static_cast<const char*>(data); }
+
+   const char* end() const { return begin() + size; }
+
+   void* data;
+   size_t size;
+};
+
+static const char*
+readArray(const char* pos, const char* end, void* dest, size_t size)
+{
+   if (static_cast<size_t>(end - pos) < padded(size))
+      throw std::runtime_error("snapshot file is truncated");
+
+   if (size > 0)
+      std::memcpy(dest, pos, size);
+
+   return pos + padded(size);
+}
+
+template <typename T>
+static const char*
+readVector(const char* pos, const char* end, std::vector<T>& vec,
+           size_t size)
+{
+   // checked before allocating, the size comes from the file
+   if (size > static_cast<size_t>(end - pos) / sizeof(T))
+      throw std::runtime_error("snapshot file is truncated");
+
+   vec.resize(size);
+   return readArray(pos, end, vec.data(), size * sizeof(T));
+}
+
+// empty names are only written for problems without names
+static const char*
+readNames(const char* pos, const char* end, NameTable& names,
+          size_t size, bool keepNames)
+{
+   std::vector<uint64_t> offsets;
+   pos = readVector(pos, end, offsets, size + 1);
+
+   if (offsets[0] != 0 ||
+       !std::is_sorted(offsets.begin(), offsets.end()))
+      throw std::runtime_error("invalid snapshot file");
+
+   if (!keepNames || offsets.back() == 0)
+   {
+      if (static_cast<size_t>(end - pos) < padded(offsets.back()))
+         throw std::runtime_error("snapshot file is truncated");
+
+      return pos + padded(offsets.back());
+   }
+
+   if (static_cast<size_t>(end - pos) < offsets.back())
+      throw std::runtime_error("snapshot file is truncated");
+
+   std::string chars;
+   chars.resize(offsets.back());
+   pos = readArray(pos, end, chars.data(), chars.size());
+
+   names = NameTable(std::move(chars), std::move(offsets));
+
+   return pos;
+}
+
+MIP
+GPHFormat::read(const std::string& file, bool keepNames)
+{
+   SnapshotMapping mapping(file);
+
+   SnapshotHeader header;
+   const char* pos = mapping.begin();
+   const char* end = mapping.end();
+   pos = readArray(pos, end, &header, sizeof(header));
+
+   if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)))
+      throw std::runtime_error("invalid snapshot file");
+
+   if (header.version != version)
+      throw std::runtime_error("snapshot version " +
+                               std::to_string(header.version) +
+                               " is not supported");
+
+   if (header.byteorder != snapshot_byteorder)
+      throw std::runtime_error("snapshot written with another byte order");
+
+   MIP mip;
+   mip.stats = header.stats;
+   mip.objoffset = header.objoffset;
+
+   const size_t ncols = mip.stats.ncols;
+   const size_t nrows = mip.stats.nrows;
+   const size_t nnz = mip.stats.nnzmat;
+
+   pos = readVector(pos, end, mip.objective, ncols);
+   pos = readVector(pos, end, mip.lb, ncols);
+   pos = readVector(pos, end, mip.ub, ncols);
+   pos = readVector(pos, end, mip.lhs, nrows);
+   pos = readVector(pos, end, mip.rhs, nrows);
+   pos = readVector(pos, end, mip.downLocks, ncols);
+   pos = readVector(pos, end, mip.upLocks, ncols);
+
+   // row-major
+   pos = readVector(pos, end, mip.constMatrix.coefficients, nnz);
+   pos = readVector(pos, end, mip.constMatrix.indices, nnz);
+   pos = readVector(pos, end, mip.constMatrix.rowStart, nrows + 1);
+   mip.constMatrix.nrows = nrows;
+   mip.constMatrix.ncols = ncols;
+
+   // column-major
+   pos = readVector(pos, end, mip.constMatrixT.coefficients, nnz);
+   pos = readVector(pos, end, mip.constMatrixT.indices, nnz);
+   pos = readVector(pos, end, mip.constMatrixT.rowStart, ncols + 1);
+   mip.constMatrixT.nrows = ncols;
+   mip.constMatrixT.ncols = nrows;
+
+   if (static_cast<size_t>(mip.constMatrix.rowStart[nrows]) != nnz ||
+       static_cast<size_t>(mip.constMatrixT.rowStart[ncols]) != nnz)
+      throw std::runtime_error("invalid snapshot file");
+
+   mip.constMatrix.compress();
+   mip.constMatrixT.compress();
+
+   pos = readNames(pos, end, mip.varNames, ncols, keepNames);
+   pos = readNames(pos, end, mip.consNames, nrows, keepNames);
+
+#ifndef NDEBUG
+   printStats(mip.stats);
+#endif
+
+   return mip;
+}
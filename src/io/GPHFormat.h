@@ -0,0 +1,25 @@
+#ifndef GPHFORMAT_HPP
+#define GPHFORMAT_HPP
+
+#include "core/MIP.h"
+
+#include <cstdint>
+#include <string>
+
+// binary snapshot of a parsed problem
+// the file starts with a header followed by the arrays of the MIP, each
+// array is aligned to 8 bytes, the file is memory mapped and the arrays
+// are copied without any parsing
+struct GPHFormat
+{
+   static MIP read(const std::string& file, bool keepNames = true);
+
+   // problems without names are written with empty names
+   static void write(const std::string& file, const MIP& mip);
+
+   // must be increased when the layout of the file or of Statistics
+   // changes
+   static constexpr uint32_t version = 1;
+};
+
+#endif
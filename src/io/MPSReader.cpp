@@ -1,145 +1,358 @@
 #include "MPSReader.h"
 #include "Message.h"
+#include "NumberParser.h"
 #include "core/Common.h"
 #include "core/Numerics.h"
 #include "core/Timer.h"
 #include <cstring>
 #include <exception>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+#include <tbb/blocked_range.h>
+#include <tbb/concurrent_queue.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #ifdef ZLIB_FOUND
 #include <zlib.h>
+#endif
 
-static std::string
-decompress_string(const std::string& str)
+// inflates a gzip file chunk by chunk on a separate thread so that the
+// decompression overlaps with the parsing
+class GzipStream
+{
+ public:
+   explicit GzipStream(const std::string& filename)
+       : in(filename, std::ios::binary), failed(false)
+   {
+#ifndef ZLIB_FOUND
+      throw std::runtime_error("The library was built without zlib");
+#endif
+      if (!in.is_open())
+         throw std::runtime_error("unable to open file");
+
+      chunks.set_capacity(max_chunks);
+      producer = std::thread([this]() { inflateFile(); });
+   }
+
+   ~GzipStream()
+   {
+      // unblock the producer if the parsing stopped early
+      chunks.abort();
+      producer.join();
+   }
+
+   // gets the next decompressed chunk, returns false at the end of the
+   // file
+   bool read(std::string& chunk)
+   {
+      // the end chunk is only pushed once
+      if (eof)
+         return false;
+
+      chunks.pop(chunk);
+
+      if (chunk.empty())
+      {
+         eof = true;
+
+         if (failed)
+            throw std::runtime_error(
+                "Exception during zlib decompression");
+      }
+
+      return !chunk.empty();
+   }
+
+ private:
+   void inflateFile();
+
+   std::ifstream in;
+   std::thread producer;
+
+   // decompressed chunks, an empty chunk marks the end of the file
+   tbb::concurrent_bounded_queue<std::string> chunks;
+   std::atomic<bool> failed;
+   // the end chunk has been popped
+   bool eof = false;
+
+   static constexpr size_t chunk_size = 1 << 20;
+   static constexpr int max_chunks = 4;
+};
+
+#ifdef ZLIB_FOUND
+
+void
+GzipStream::inflateFile()
 {
    z_stream zs;
    std::memset(&zs, 0, sizeof(zs));
 
    if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK)
-      throw std::runtime_error("inflateInit failed while decompressing.");
-
-   zs.next_in = (unsigned char*)str.data();
-   zs.avail_in = str.size();
+   {
+      failed = true;
+      chunks.push(std::string());
+      return;
+   }
 
-   int ret;
-   char outbuffer[32768];
-   std::string outstring;
+   std::vector<char> inbuffer(chunk_size);
+   int ret = Z_OK;
 
-   do
+   try
    {
-      zs.next_out = reinterpret_cast<unsigned char*>(outbuffer);
-      zs.avail_out = sizeof(outbuffer);
+      while (ret == Z_OK)
+      {
+         std::string chunk(chunk_size, '\0');
+         zs.next_out = reinterpret_cast<unsigned char*>(&chunk[0]);
+         zs.avail_out = chunk_size;
 
-      ret = inflate(&zs, 0);
+         // fill a whole chunk
+         while (ret == Z_OK && zs.avail_out > 0)
+         {
+            if (zs.avail_in == 0)
+            {
+               in.read(inbuffer.data(), inbuffer.size());
+               zs.next_in =
+                   reinterpret_cast<unsigned char*>(inbuffer.data());
+               zs.avail_in = in.gcount();
+
+               // truncated file
+               if (zs.avail_in == 0)
+               {
+                  ret = Z_DATA_ERROR;
+                  break;
+               }
+            }
+
+            ret = inflate(&zs, Z_NO_FLUSH);
+         }
 
-      if (outstring.size() < zs.total_out)
-         outstring.append(outbuffer, zs.total_out - outstring.size());
+         chunk.resize(chunk_size - zs.avail_out);
+         if (!chunk.empty())
+            chunks.push(std::move(chunk));
+      }
 
-   } while (ret == Z_OK);
+      failed = ret != Z_STREAM_END;
+      chunks.push(std::string());
+   }
+   catch (const tbb::user_abort&)
+   {
+   }
 
    inflateEnd(&zs);
-
-   if (ret != Z_STREAM_END)
-      throw std::runtime_error("Exception during zlib decompression");
-
-   return outstring;
 }
 
 #else
 
-static std::string
-decompress_string(const std::string&)
+void
+GzipStream::inflateFile()
 {
-   throw std::runtime_error("The library was built without zlib");
-
-   return {};
 }
 
 #endif
 
 MPSWrapper::MPSWrapper(const std::string& filename)
-    : ptr(0), integer_section(false), linenb(0)
+    : mapping(nullptr), mapsize(0), integer_section(false), linenb(0)
 {
-   std::fstream in(filename);
-   in.seekg(0, std::ios::end);
-   std::streampos size = in.tellg();
-   in.seekg(0, std::ios::beg);
-   content.resize(size);
-   in.read(&content[0], size);
-   in.close();
-
+   const char* text_begin = nullptr;
    auto pos = filename.find_last_of('.');
 
-   if (filename.substr(pos + 1) == "gz")
+   if (pos != std::string::npos && filename.substr(pos + 1) == "gz")
    {
-      std::string temp = decompress_string(content);
-      content = std::move(temp);
+      gzstream = std::make_unique<GzipStream>(filename);
+      text_end = nullptr;
    }
+   else
+   {
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+         throw std::runtime_error("unable to open file");
+
+      struct stat filestat;
+      if (fstat(fd, &filestat) != 0)
+      {
+         close(fd);
+         throw std::runtime_error("unable to open file");
+      }
 
-   buf = nullptr;
-   next = &content[0];
+      mapsize = filestat.st_size;
 
-   for (size_t i = 0; i < content.size(); ++i)
-   {
-      if (content[i] == tab)
-         content[i] = blank;
-      else if (content[i] == '\r')
-         content[i] = '\n';
+      if (mapsize > 0)
+      {
+         mapping = mmap(nullptr, mapsize, PROT_READ, MAP_PRIVATE, fd, 0);
+         close(fd);
+
+         if (mapping == MAP_FAILED)
+         {
+            mapping = nullptr;
+            throw std::runtime_error("unable to map file");
+         }
+
+         // the file is read once from the beginning to the end
+         madvise(mapping, mapsize, MADV_SEQUENTIAL);
+      }
+      else
+         close(fd);
+
+      text_begin = static_cast<const char*>(mapping);
+      text_end = text_begin + mapsize;
    }
+
+   next = text_begin;
+   line_end = text_begin;
+   cursor = text_begin;
+}
+
+MPSWrapper::MPSWrapper(std::string_view text)
+    : mapping(nullptr), mapsize(0), text_end(text.data() + text.size()),
+      next(text.data()), line_end(text.data()), cursor(text.data()),
+      integer_section(false), linenb(0)
+{
+}
+
+MPSWrapper::~MPSWrapper()
+{
+   if (mapping)
+      munmap(mapping, mapsize);
 }
 
+// moves the unparsed part of the decompressed text to the front of the
+// buffer and appends the next chunk
 bool
-MPSWrapper::getLine() noexcept
+MPSWrapper::refill()
 {
-   buf = next;
+   if (!gzstream)
+      return false;
 
-   if (ptr == content.size())
+   std::string chunk;
+   if (!gzstream->read(chunk))
       return false;
 
+   size_t unparsed = text_end ? text_end - cursor : 0;
+   size_t next_offset = text_end ? next - cursor : 0;
+
+   content.erase(0, content.size() - unparsed);
+   content.append(chunk);
+
+   cursor = content.data();
+   next = cursor + next_offset;
+   line_end = cursor;
+   text_end = cursor + content.size();
+
+   return true;
+}
+
+bool
+MPSWrapper::getLine()
+{
+   if (next == text_end)
+   {
+      cursor = next;
+      if (!refill())
+         return false;
+   }
+
+   cursor = next;
+
    do
    {
-      ++next;
-      ++ptr;
-   } while (ptr < content.size() && *next != '\n');
+      while (next != text_end && *next != '\n' && *next != '\r')
+         ++next;
 
-   while (ptr < content.size() && *next == '\n')
+      // the line continues in the next chunk
+   } while (next == text_end && refill());
+
+   line_end = next;
+
+   // skip the line terminators and empty lines
+   while (next != text_end && (*next == '\n' || *next == '\r'))
    {
-      ++linenb;
-      *next = '\0';
+      if (*next == '\n')
+         ++linenb;
       ++next;
-      ++ptr;
    }
 
    return true;
 }
 
+std::string_view
+MPSWrapper::keep(std::string_view field)
+{
+   if (!gzstream)
+      return field;
+
+   if (field.size() > kept_left)
+   {
+      kept_left = std::max(field.size(), kept_block_size);
+      kept_blocks.emplace_back(new char[kept_left]);
+      kept_next = kept_blocks.back().get();
+   }
+
+   std::memcpy(kept_next, field.data(), field.size());
+   std::string_view kept(kept_next, field.size());
+
+   kept_next += field.size();
+   kept_left -= field.size();
+
+   return kept;
+}
+
+std::string_view
+MPSWrapper::nextField() noexcept
+{
+   while (cursor != line_end && (*cursor == blank || *cursor == tab))
+      ++cursor;
+
+   const char* field_begin = cursor;
+
+   while (cursor != line_end && *cursor != blank && *cursor != tab)
+      ++cursor;
+
+   return {field_begin, static_cast<size_t>(cursor - field_begin)};
+}
+
 bool
-MPSWrapper::readLine() noexcept
+MPSWrapper::readLine()
 {
    bool marker;
    do
    {
       marker = false;
 
-      field_1 = nullptr;
-      field_2 = nullptr;
-      field_3 = nullptr;
-      field_4 = nullptr;
-      field_5 = nullptr;
+      field_1 = {};
+      field_2 = {};
+      field_3 = {};
+      field_4 = {};
+      field_5 = {};
 
+      bool comment;
       do
       {
          if (!getLine())
             return false;
 
-      } while (buf[0] == '*' || buf[0] == '\n');
+         new_section = cursor != line_end && *cursor != blank &&
+                      *cursor != tab;
+         comment = cursor != line_end && *cursor == '*';
+
+         if (!comment)
+            field_1 = nextField();
+
+         // skip comments and blank lines
+      } while (comment || field_1.empty());
 
       // new section
-      if (buf[0] != blank)
+      if (new_section)
       {
-         field_1 = std::strtok(buf, " ");
-         if (!std::strcmp(field_1, "NAME"))
-            field_2 = std::strtok(nullptr, " ");
+         if (field_1 == "NAME")
+            field_2 = nextField();
          return true;
       }
 
@@ -147,56 +360,110 @@ MPSWrapper::readLine() noexcept
       // if it's a marker change integer_section and
       // move to the next line
       // else get the tokens and return
-      do
+      field_2 = nextField();
+      if (field_2.empty())
+         break;
+
+      if (field_2 == "'MARKER'")
       {
-         field_1 = std::strtok(buf + 1, " ");
-         assert(field_1);
+         marker = true;
+         ++nmarkers;
+
+         field_3 = nextField();
+         if (field_3 == "'INTORG'")
+            integer_section = true;
+         else if (field_3 == "'INTEND'")
+            integer_section = false;
+         else
+            return false;
 
-         if (!(field_2 = std::strtok(nullptr, " ")))
-            break;
+         continue;
+      }
 
-         if (!std::strcmp(field_2, "'MARKER'"))
-            marker = true;
+      field_3 = nextField();
+      if (field_3.empty())
+         break;
 
-         if (marker)
-         {
-            if (!(field_3 = std::strtok(nullptr, " ")))
-               return false;
+      field_4 = nextField();
+      if (field_4.empty())
+         break;
 
-            if (!std::strcmp(field_3, "'INTORG'"))
-               integer_section = true;
-            else if (!std::strcmp(field_3, "'INTEND'"))
-               integer_section = false;
-            else
-               return false;
+      field_5 = nextField();
+   } while (marker);
 
-            break;
-         }
+   return true;
+}
 
-         if (!(field_3 = std::strtok(nullptr, " ")))
-            break;
+std::string_view
+MPSWrapper::readSection() noexcept
+{
+   assert(isMapped());
+   const char* section_begin = next;
 
-         if (!(field_4 = std::strtok(nullptr, " ")))
-            break;
+   while (next != text_end && (*next == blank || *next == tab ||
+                               *next == '*' || *next == '\n' ||
+                               *next == '\r'))
+   {
+      while (next != text_end && *next != '\n' && *next != '\r')
+         ++next;
 
-         field_5 = std::strtok(nullptr, " ");
+      while (next != text_end && (*next == '\n' || *next == '\r'))
+         ++next;
+   }
 
-         break;
-      } while (false);
-   } while (marker);
+   return {section_begin, static_cast<size_t>(next - section_begin)};
+}
 
-   return true;
+// returns the beginning of the first line at or after pos that starts a
+// new column, comments and empty lines are skipped
+static const char*
+nextColumnStart(const char* pos, const char* begin, const char* end)
+{
+   auto skipLine = [end](const char* p) {
+      while (p != end && *p != '\n' && *p != '\r')
+         ++p;
+      while (p != end && (*p == '\n' || *p == '\r'))
+         ++p;
+      return p;
+   };
+
+   auto firstField = [end](const char* p) -> std::string_view {
+      while (p != end && (*p == ' ' || *p == '\t'))
+         ++p;
+      const char* field_begin = p;
+      while (p != end && *p != ' ' && *p != '\t' && *p != '\n' &&
+             *p != '\r')
+         ++p;
+      return {field_begin, static_cast<size_t>(p - field_begin)};
+   };
+
+   // move to the beginning of a line
+   if (pos != begin && pos[-1] != '\n' && pos[-1] != '\r')
+      pos = skipLine(pos);
+
+   std::string_view previous;
+   while (pos != end)
+   {
+      std::string_view name = firstField(pos);
+
+      if (*pos != '*' && !name.empty())
+      {
+         if (!previous.empty() && name != previous)
+            return pos;
+         previous = name;
+      }
+
+      pos = skipLine(pos);
+   }
+
+   return end;
 }
 
 // read the mps, fill a transposed constraint matrix
 // construct the sparse constraint matrix from the transposed
 MIP
-MPSReader::parse(const std::string& file)
+MPSReader::parse(const std::string& file, bool keepNames)
 {
-   std::fstream in(file);
-   if (!in.is_open())
-      throw std::runtime_error("unable to open file");
-
    MPSWrapper mps(file);
 
    std::string name;
@@ -215,16 +482,13 @@ MPSReader::parse(const std::string& file)
    std::vector<double> lbs;
    std::vector<double> ubs;
 
-   std::vector<std::string> varNames;
-   std::vector<std::string> consNames;
+   NameTable varNames;
 
    std::vector<double> objective;
    std::string objName;
 
    dynamic_bitset<> integer;
 
-   std::vector<int> rowSize;
-
    Timer::time_point t0;
    Timer::time_point t1;
 
@@ -250,7 +514,7 @@ MPSReader::parse(const std::string& file)
          t0 = Timer::now();
          nextsection =
              parseColumns(mps, rows, cols, coefsT, idxT, rstatrtT,
-                          objective, objName, integer, rowSize, varNames);
+                          objective, objName, integer, varNames);
          t1 = Timer::now();
          Message::debug("Section COLUMNS parsed in {:0.2f}s",
                         Timer::seconds(t1, t0));
@@ -290,21 +554,55 @@ MPSReader::parse(const std::string& file)
       throw std::runtime_error("unable to parse MPS file (error in line " +
                                std::to_string(mps.getLineNb()) + ")");
 
-   return MIP(rows, cols, std::move(coefsT), std::move(idxT),
-              std::move(rstatrtT), std::move(rhs), std::move(lhs),
-              std::move(lbs), std::move(ubs), std::move(objective),
-              std::move(integer), rowSize, std::move(varNames));
+   NameTable consNames;
+   if (keepNames)
+      consNames = rowNames(rows);
+   else
+      varNames = NameTable();
+
+   int nrows = rows.size();
+
+   // the maps are not needed anymore, release them before the matrix is
+   // transposed
+   rows = Rows();
+   cols = Cols();
+
+   return MIP(std::move(coefsT), std::move(idxT), std::move(rstatrtT),
+              std::move(rhs), std::move(lhs), std::move(lbs),
+              std::move(ubs), std::move(objective), std::move(integer),
+              nrows, std::move(varNames), std::move(consNames));
+}
+
+// the constraint names in the order of the rows
+NameTable
+MPSReader::rowNames(const Rows& rows)
+{
+   std::vector<std::string_view> names(rows.size());
+   size_t nchars = 0;
+   for (const auto& elem : rows)
+   {
+      int row = elem.second.second;
+      names[row] = elem.first;
+      nchars += elem.first.size();
+   }
+
+   NameTable table;
+   table.reserve(names.size(), nchars);
+   for (auto name : names)
+      table.push_back(name);
+
+   return table;
 }
 
 MPSReader::Section
 MPSReader::parseName(MPSWrapper& mps, std::string& name)
 {
-   if (!mps.readLine() || std::strcmp(mps.field1(), "NAME"))
+   if (!mps.readLine() || mps.field1() != "NAME")
       return FORMAT_ERROR;
 
    name = std::string(mps.field2());
 
-   if (!mps.readLine() || std::strcmp(mps.field1(), "ROWS"))
+   if (!mps.readLine() || mps.field1() != "ROWS")
       return FORMAT_ERROR;
 
    return ROWS;
@@ -321,10 +619,10 @@ MPSReader::parseRows(MPSWrapper& mps, Rows& rows, std::string& objname)
       if (!mps.readLine())
          return FORMAT_ERROR;
 
-      if (!mps.field2())
+      if (mps.field2().empty())
          break;
 
-      if (std::strlen(mps.field1()) > 1)
+      if (mps.field1().size() > 1)
          return FORMAT_ERROR;
 
       switch (mps.field1()[0])
@@ -348,8 +646,8 @@ MPSReader::parseRows(MPSWrapper& mps, Rows& rows, std::string& objname)
 
       if (type != OBJECTIVE)
       {
-         auto pair =
-             rows.emplace(mps.field2(), std::make_pair(type, rowcounter));
+         auto pair = rows.emplace(mps.keep(mps.field2()),
+                                  std::make_pair(type, rowcounter));
          ++rowcounter;
 
          // duplicate rows
@@ -358,160 +656,213 @@ MPSReader::parseRows(MPSWrapper& mps, Rows& rows, std::string& objname)
       }
    }
 
-   if (std::strcmp(mps.field1(), "COLUMNS"))
+   if (mps.field1() != "COLUMNS")
       return FORMAT_ERROR;
    return COLUMNS;
 }
 
-MPSReader::Section
-MPSReader::parseColumns(MPSWrapper& mps, const Rows& rows, Cols& cols,
-                        std::vector<double>& coefs, std::vector<int>& idxT,
-                        std::vector<int>& rstart,
-                        std::vector<double>& objective,
-                        const std::string& objname,
-                        dynamic_bitset<>& integer,
-                        std::vector<int>& rowSize,
-                        std::vector<std::string>& varNames)
+bool
+MPSReader::parseColumnChunk(MPSWrapper& mps, const Rows& rows,
+                            const std::string& objname,
+                            ColumnChunk& chunk)
 {
-   int colid = -1;
-   std::string row_name;
-   objective.clear();
+   std::string_view current_col;
 
-   rowSize = std::vector<int>(rows.size(), 0);
-
-   while (true)
+   while (mps.readLine())
    {
-      if (!mps.readLine())
-         return FORMAT_ERROR;
-
-      if (!mps.field2())
+      // next section, it is only seen at the real end of the COLUMNS
+      // section, a chunk never contains it
+      if (mps.isNewSection())
          break;
 
-      if (!mps.field3())
-         return FORMAT_ERROR;
+      if (mps.field3().empty())
+         return false;
 
-      if (varNames.empty() ||
-          std::strcmp(mps.field1(), varNames.back().c_str()))
+      if (chunk.names.empty() || mps.field1() != current_col)
       {
-         ++colid;
-         std::string current_col(mps.field1());
-
-         auto insertion = cols.emplace(current_col, colid);
-         if (!insertion.second)
-            return FORMAT_ERROR;
+         current_col = mps.keep(mps.field1());
 
          // the last row of the transposed matrix ends here
-         rstart.push_back(coefs.size());
-         integer.push_back(mps.isIntSection());
+         chunk.colstart.push_back(chunk.coefs.size());
+         chunk.names.push_back(current_col);
+         chunk.integer.push_back(mps.isIntSection());
+         chunk.objective.push_back(0.0);
 
-         varNames.push_back(std::move(current_col));
-
-         assert(varNames.size() == static_cast<size_t>(colid + 1));
+         if (mps.getNMarkers() == 0)
+            ++chunk.nunmarked;
       }
-      assert(coefs.size() == idxT.size());
+      assert(chunk.coefs.size() == chunk.indices.size());
 
-      double coef;
-      try
+      for (int entry = 0; entry < 2; ++entry)
       {
-         coef = std::stod(mps.field3());
-      }
-      catch (const std::exception& ex)
-      {
-         return FORMAT_ERROR;
-      }
+         std::string_view rowname = entry ? mps.field4() : mps.field2();
+         std::string_view value = entry ? mps.field5() : mps.field3();
 
-      if (!std::strcmp(objname.c_str(), mps.field2()))
-      {
-         int beforesize = objective.size();
-         objective.resize(colid + 1);
-
-         assert(colid >= beforesize);
-         assert(objective.size() == static_cast<size_t>(colid) + 1);
+         if (rowname.empty())
+            break;
 
-         std::memset(objective.data() + beforesize, 0,
-                     sizeof(double) * (colid - beforesize));
+         double coef;
+         if (!parseDouble(value, coef))
+            return false;
 
-         objective[colid] = coef;
-      }
-      else
-      {
-         auto iter = rows.find(mps.field2());
-         // row not declared in the ROWS section
-         if (iter == rows.end())
+         if (rowname == objname)
          {
-            return FORMAT_ERROR;
+            chunk.objective.back() = coef;
+            continue;
          }
 
-         auto rowid = iter->second.second;
+         auto iter = rows.find(rowname);
+         // row not declared in the ROWS section
+         if (iter == rows.end())
+            return false;
 
          if (coef != 0.0)
          {
-            coefs.push_back(coef);
-            idxT.push_back(rowid);
-            ++rowSize[rowid];
+            chunk.coefs.push_back(coef);
+            chunk.indices.push_back(iter->second.second);
          }
-
-         assert(coefs.size() == idxT.size());
       }
+   }
 
-      if (!mps.field4())
-         continue;
-      if (!mps.field5())
-         return FORMAT_ERROR;
+   chunk.nmarkers = mps.getNMarkers();
+   chunk.integer_end = mps.isIntSection();
 
-      try
+   return true;
+}
+
+MPSReader::Section
+MPSReader::parseColumns(MPSWrapper& mps, const Rows& rows, Cols& cols,
+                        std::vector<double>& coefs, std::vector<int>& idxT,
+                        std::vector<int>& rstart,
+                        std::vector<double>& objective,
+                        const std::string& objname,
+                        dynamic_bitset<>& integer,
+                        NameTable& varNames)
+{
+   std::vector<ColumnChunk> chunks;
+
+   if (mps.isMapped())
+   {
+      // split the section at column boundaries and parse the chunks in
+      // parallel
+      std::string_view section = mps.readSection();
+      const char* section_end = section.data() + section.size();
+
+      size_t maxchunks = 4 * tbb::this_task_arena::max_concurrency();
+      size_t nchunks =
+          std::min(section.size() / min_chunk_size + 1, maxchunks);
+
+      std::vector<const char*> bounds{section.data()};
+      for (size_t i = 1; i < nchunks; ++i)
       {
-         coef = std::stod(mps.field5());
+         const char* pos = std::max(
+             bounds.back(), section.data() + i * section.size() / nchunks);
+         pos = nextColumnStart(pos, section.data(), section_end);
+
+         if (pos != bounds.back() && pos != section_end)
+            bounds.push_back(pos);
       }
-      catch (const std::exception& ex)
+      bounds.push_back(section_end);
+
+      chunks.resize(bounds.size() - 1);
+      tbb::parallel_for(
+          tbb::blocked_range<size_t>(0, chunks.size(), 1),
+          [&](const tbb::blocked_range<size_t>& range) {
+             for (size_t i = range.begin(); i != range.end(); ++i)
+             {
+                MPSWrapper chunkmps(std::string_view(
+                    bounds[i], static_cast<size_t>(bounds[i + 1] -
+                                                   bounds[i])));
+
+                chunks[i].valid =
+                    parseColumnChunk(chunkmps, rows, objname, chunks[i]);
+                chunks[i].nlines = chunkmps.getLineNb();
+             }
+          });
+
+      // report the line of the first error
+      for (const auto& chunk : chunks)
       {
-         return FORMAT_ERROR;
+         mps.countLines(chunk.nlines);
+         if (!chunk.valid)
+            return FORMAT_ERROR;
       }
 
-      if (!std::strcmp(objname.c_str(), mps.field4()))
-      {
-         int beforesize = objective.size();
-         objective.resize(colid + 1);
+      mps.readLine();
+   }
+   else
+   {
+      chunks.resize(1);
+      if (!parseColumnChunk(mps, rows, objname, chunks[0]))
+         return FORMAT_ERROR;
+   }
 
-         assert(colid >= beforesize);
-         assert(objective.size() == static_cast<size_t>(colid) + 1);
+   // stitch the chunks
+   size_t ncols = 0;
+   size_t nchars = 0;
+   for (const auto& chunk : chunks)
+   {
+      ncols += chunk.names.size();
+      for (auto name : chunk.names)
+         nchars += name.size();
+   }
 
-         std::memset(objective.data() + beforesize, 0,
-                     sizeof(double) * (colid - beforesize));
+   varNames.reserve(ncols, nchars);
+   rstart.reserve(ncols + 1);
 
-         objective[colid] = coef;
-      }
-      else
+   bool integer_section = false;
+   for (size_t c = 0; c < chunks.size(); ++c)
+   {
+      ColumnChunk& chunk = chunks[c];
+      int offset = coefs.size();
+
+      for (size_t i = 0; i < chunk.names.size(); ++i)
       {
-         auto iter = rows.find(mps.field4());
-         // row not declared in the ROWS section
-         if (iter == rows.end())
+         int colid = varNames.size();
+
+         auto insertion = cols.emplace(chunk.names[i], colid);
+         if (!insertion.second)
             return FORMAT_ERROR;
 
-         auto rowid = iter->second.second;
-         if (coef != 0.0)
-         {
-            coefs.push_back(coef);
-            idxT.push_back(rowid);
-            ++rowSize[rowid];
-         }
+         varNames.push_back(chunk.names[i]);
+         rstart.push_back(offset + chunk.colstart[i]);
 
-         assert(coefs.size() == idxT.size());
+         if (static_cast<int>(i) < chunk.nunmarked)
+            integer.push_back(integer_section);
+         else
+            integer.push_back(chunk.integer[i]);
       }
+
+      if (chunk.nmarkers > 0)
+         integer_section = chunk.integer_end;
+
+      // the first chunk may have no coefficient but an objective
+      if (c == 0)
+      {
+         coefs = std::move(chunk.coefs);
+         idxT = std::move(chunk.indices);
+         objective = std::move(chunk.objective);
+      }
+      else
+      {
+         coefs.insert(coefs.end(), chunk.coefs.begin(), chunk.coefs.end());
+         idxT.insert(idxT.end(), chunk.indices.begin(),
+                     chunk.indices.end());
+         objective.insert(objective.end(), chunk.objective.begin(),
+                          chunk.objective.end());
+      }
+
+      // free the chunk
+      chunk = ColumnChunk();
    }
 
    // end the last row
    rstart.push_back(coefs.size());
 
-   int ncols = static_cast<int>(colid + 1);
-   int beforesize = objective.size();
-   objective.resize(ncols);
-
-   assert(ncols >= beforesize);
-   std::memset(objective.data() + beforesize, 0,
-               sizeof(double) * (ncols - beforesize));
+   assert(objective.size() == ncols);
+   assert(coefs.size() == idxT.size());
 
-   if (!std::strcmp(mps.field1(), "RHS"))
+   if (mps.field1() == "RHS")
       return RHS;
 
    return FORMAT_ERROR;
@@ -558,9 +909,9 @@ MPSReader::parseRhs(MPSWrapper& mps, const Rows& rows,
       if (!mps.readLine())
          return FORMAT_ERROR;
 
-      if (!mps.field2())
+      if (mps.field2().empty())
          break;
-      if (!mps.field3())
+      if (mps.field3().empty())
          return FORMAT_ERROR;
 
       auto iter = rows.find(mps.field2());
@@ -570,14 +921,8 @@ MPSReader::parseRhs(MPSWrapper& mps, const Rows& rows,
       int rowid = iter->second.second;
 
       double side;
-      try
-      {
-         side = std::stod(mps.field3());
-      }
-      catch (const std::exception& ex)
-      {
+      if (!parseDouble(mps.field3(), side))
          return FORMAT_ERROR;
-      }
 
       switch (iter->second.first)
       {
@@ -598,9 +943,9 @@ MPSReader::parseRhs(MPSWrapper& mps, const Rows& rows,
          break;
       }
 
-      if (!mps.field4())
+      if (mps.field4().empty())
          continue;
-      if (!mps.field5())
+      if (mps.field5().empty())
          return FORMAT_ERROR;
 
       iter = rows.find(mps.field4());
@@ -609,14 +954,8 @@ MPSReader::parseRhs(MPSWrapper& mps, const Rows& rows,
 
       rowid = iter->second.second;
 
-      try
-      {
-         side = std::stod(mps.field5());
-      }
-      catch (const std::exception& ex)
-      {
+      if (!parseDouble(mps.field5(), side))
          return FORMAT_ERROR;
-      }
 
       switch (iter->second.first)
       {
@@ -639,9 +978,9 @@ MPSReader::parseRhs(MPSWrapper& mps, const Rows& rows,
 
    } while (true);
 
-   if (!std::strcmp(mps.field1(), "BOUNDS"))
+   if (mps.field1() == "BOUNDS")
       return BOUNDS;
-   if (!std::strcmp(mps.field1(), "RANGES"))
+   if (mps.field1() == "RANGES")
       return RANGES;
 
    return FORMAT_ERROR;
@@ -665,9 +1004,9 @@ MPSReader::parseBounds(MPSWrapper& mps, const Cols& cols,
    {
       if (!mps.readLine())
          return FORMAT_ERROR;
-      if (!mps.field2())
+      if (mps.field2().empty())
          break;
-      if (!mps.field3())
+      if (mps.field3().empty())
          return FORMAT_ERROR;
 
       auto iter = cols.find(mps.field3());
@@ -676,56 +1015,50 @@ MPSReader::parseBounds(MPSWrapper& mps, const Cols& cols,
       int colid = iter->second;
 
       double bound = 0.0;
-      if (mps.field4())
+      if (!mps.field4().empty())
       {
-         try
-         {
-            bound = std::stod(mps.field4());
-         }
-         catch (const std::exception& ex)
-         {
+         if (!parseDouble(mps.field4(), bound))
             return FORMAT_ERROR;
-         }
       }
 
-      if (!std::strcmp(mps.field1(), "UP"))
+      if (mps.field1() == "UP")
       {
-         if (!mps.field4())
+         if (mps.field4().empty())
             return FORMAT_ERROR;
          ubs[colid] = bound;
          if (bound < 0.0 && !lb_changed[colid])
             lbs[colid] = -inf;
       }
-      else if (!std::strcmp(mps.field1(), "LO"))
+      else if (mps.field1() == "LO")
       {
-         if (!mps.field4())
+         if (mps.field4().empty())
             return FORMAT_ERROR;
          lbs[colid] = bound;
          lb_changed[colid] = true;
       }
-      else if (!std::strcmp(mps.field1(), "FX"))
+      else if (mps.field1() == "FX")
       {
-         if (!mps.field4())
+         if (mps.field4().empty())
             return FORMAT_ERROR;
          lbs[colid] = bound;
          ubs[colid] = bound;
       }
-      else if (!std::strcmp(mps.field1(), "MI"))
+      else if (mps.field1() == "MI")
          lbs[colid] = -inf;
-      else if (!std::strcmp(mps.field1(), "PL"))
+      else if (mps.field1() == "PL")
          ubs[colid] = inf;
-      else if (!std::strcmp(mps.field1(), "FX"))
+      else if (mps.field1() == "FX")
       {
          lbs[colid] = -inf;
          ubs[colid] = inf;
       }
-      else if (!std::strcmp(mps.field1(), "BV"))
+      else if (mps.field1() == "BV")
       {
          lbs[colid] = 0.0;
          ubs[colid] = 1.0;
          integer[colid] = true;
       }
-      else if (!std::strcmp(mps.field1(), "FR"))
+      else if (mps.field1() == "FR")
       {
          lbs[colid] = -inf;
          ubs[colid] = inf;
@@ -734,7 +1067,7 @@ MPSReader::parseBounds(MPSWrapper& mps, const Cols& cols,
          return FORMAT_ERROR;
    } while (true);
 
-   if (std::strcmp(mps.field1(), "ENDATA"))
+   if (mps.field1() != "ENDATA")
       return FORMAT_ERROR;
 
    return END;
@@ -744,19 +1077,19 @@ MPSReader::Section
 MPSReader::parseRanges(MPSWrapper& mps, const Rows& rows,
                        std::vector<double>& lhs, std::vector<double>& rhs)
 {
-   std::string rangeVectorName;
+   std::string_view rangeVectorName;
 
    do
    {
       if (!mps.readLine())
          return FORMAT_ERROR;
-      if (!mps.field2())
+      if (mps.field2().empty())
          break;
-      if (!mps.field3())
+      if (mps.field3().empty())
          return FORMAT_ERROR;
       if (rangeVectorName.empty())
-         rangeVectorName = std::string(mps.field1());
-      else if (std::strcmp(rangeVectorName.c_str(), mps.field1()))
+         rangeVectorName = mps.keep(mps.field1());
+      else if (rangeVectorName != mps.field1())
          // TODO warning
          continue;
 
@@ -768,14 +1101,8 @@ MPSReader::parseRanges(MPSWrapper& mps, const Rows& rows,
       ConsType type = iter->second.first;
       int rowid = iter->second.second;
       double range;
-      try
-      {
-         range = std::stod(mps.field3());
-      }
-      catch (const std::exception& ex)
-      {
+      if (!parseDouble(mps.field3(), range))
          return FORMAT_ERROR;
-      }
 
       switch (type)
       {
@@ -798,7 +1125,7 @@ MPSReader::parseRanges(MPSWrapper& mps, const Rows& rows,
 
    } while (true);
 
-   if (!std::strcmp(mps.field1(), "BOUNDS"))
+   if (mps.field1() == "BOUNDS")
       return BOUNDS;
 
    return FORMAT_ERROR;
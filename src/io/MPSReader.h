@@ -8,56 +8,120 @@
 #include <algorithm>
 #include <cassert>
 #include <fstream>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <string_view>
 
+class GzipStream;
+
+// reads an MPS file line by line
+// plain text files are memory mapped and the fields are views into the
+// mapped pages, no copy of the file is made
+// gzip files are decompressed in chunks while they are parsed, only the
+// current chunk is kept in memory
 class MPSWrapper
 {
  public:
    explicit MPSWrapper(const std::string& filename);
 
-   bool readLine() noexcept;
+   // reads the lines of a part of the text of another wrapper
+   explicit MPSWrapper(std::string_view text);
+
+   MPSWrapper(const MPSWrapper&) = delete;
+
+   MPSWrapper& operator=(const MPSWrapper&) = delete;
+
+   ~MPSWrapper();
+
+   bool readLine();
+
+   // the fields are not null terminated and are valid until the next
+   // call to readLine, an absent field is empty
+   std::string_view field1() const { return field_1; }
+   std::string_view field2() const { return field_2; }
+   std::string_view field3() const { return field_3; }
+   std::string_view field4() const { return field_4; }
+   std::string_view field5() const { return field_5; }
+   std::string_view field6() const { return field_6; }
 
-   const char* field1() const { return field_1; }
-   const char* field2() const { return field_2; }
-   const char* field3() const { return field_3; }
-   const char* field4() const { return field_4; }
-   const char* field5() const { return field_5; }
-   const char* field6() const { return field_6; }
+   // returns a view of the field that stays valid as long as the wrapper
+   // is alive, the field is copied only if the input is compressed
+   std::string_view keep(std::string_view field);
+
+   // returns the unparsed lines up to the next section and moves to the
+   // beginning of the next section, the input must be memory mapped
+   std::string_view readSection() noexcept;
+
+   // adds lines parsed outside of the wrapper to the line counter
+   void countLines(int nlines) { linenb += nlines; }
+
+   bool isMapped() const { return mapping != nullptr; }
 
    bool isIntSection() const { return integer_section; }
 
+   int getNMarkers() const { return nmarkers; }
+
+   // the last line read starts a new section
+   bool isNewSection() const { return new_section; }
+
    int getLineNb() const { return linenb; }
 
  private:
-   bool getLine() noexcept;
+   bool getLine();
+
+   bool refill();
 
+   std::string_view nextField() noexcept;
+
+   // decompressor of gzip files, nullptr if the file is not compressed
+   std::unique_ptr<GzipStream> gzstream;
+
+   // decompressed text of gzip files: the part of the last chunk that
+   // was not parsed yet followed by the current chunk
    std::string content;
 
-   char* buf;
-   char* next;
-   size_t ptr;
+   // storage of the kept fields of gzip files
+   std::vector<std::unique_ptr<char[]>> kept_blocks;
+   char* kept_next = nullptr;
+   size_t kept_left = 0;
+
+   // memory mapped input, nullptr if the file is compressed or empty
+   void* mapping;
+   size_t mapsize;
+
+   // the text being parsed, either the mapping or the content
+   const char* text_end;
+   const char* next;
+
+   // the current line
+   const char* line_end;
+   const char* cursor;
 
    bool integer_section;
+   int nmarkers = 0;
+   bool new_section = false;
 
-   char* field_1 = nullptr;
-   char* field_2 = nullptr;
-   char* field_3 = nullptr;
-   char* field_4 = nullptr;
-   char* field_5 = nullptr;
-   char* field_6 = nullptr;
+   std::string_view field_1;
+   std::string_view field_2;
+   std::string_view field_3;
+   std::string_view field_4;
+   std::string_view field_5;
+   std::string_view field_6;
 
    int linenb = 0;
 
    static constexpr char blank = ' ';
    static constexpr char tab = '\t';
+   static constexpr size_t kept_block_size = 1 << 16;
 };
 
 class MPSReader
 {
  public:
-   static MIP parse(const std::string&);
+   // without names the problem keeps neither variable nor constraint
+   // names, solutions can then only be written with index based names
+   static MIP parse(const std::string&, bool keepNames = true);
 
  private:
    enum Section : uint8_t
@@ -73,6 +137,36 @@ class MPSReader
    };
    static Section error_section;
 
+   // minimum size in bytes of the chunks of the COLUMNS section, the
+   // unit tests use small chunks to split small instances
+#ifdef UNIT_TEST
+   static constexpr size_t min_chunk_size = 1 << 10;
+#else
+   static constexpr size_t min_chunk_size = 1 << 20;
+#endif
+
+   // part of the COLUMNS section parsed independently of the others
+   struct ColumnChunk
+   {
+      std::vector<std::string_view> names;
+      dynamic_bitset<> integer;
+      std::vector<int> colstart;
+      std::vector<double> coefs;
+      std::vector<int> indices;
+      std::vector<double> objective;
+
+      // number of columns before the first marker of the chunk, their
+      // type is given by the previous chunks
+      int nunmarked = 0;
+      int nmarkers = 0;
+      bool integer_end = false;
+
+      int nlines = 0;
+      bool valid = false;
+   };
+
+   static NameTable rowNames(const Rows& rows);
+
    static Section parseName(MPSWrapper&, std::string& name);
 
    static Section parseRows(MPSWrapper&, Rows& rows, std::string& objName);
@@ -82,7 +176,11 @@ class MPSReader
                 std::vector<double>& coefs, std::vector<int>& idxT,
                 std::vector<int>& rstart, std::vector<double>& obj,
                 const std::string& objName, dynamic_bitset<>&,
-                std::vector<int>&, std::vector<std::string>&);
+                NameTable&);
+
+   static bool parseColumnChunk(MPSWrapper&, const Rows& rows,
+                                const std::string& objName,
+                                ColumnChunk& chunk);
 
    static Section parseRhs(MPSWrapper&, const Rows& rows,
                            std::vector<double>& lhs,
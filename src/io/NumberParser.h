@@ -0,0 +1,56 @@
+#ifndef NUMBER_PARSER_HPP
+#define NUMBER_PARSER_HPP
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+// number conversion shared by the readers, it does not depend on the
+// locale and does not allocate, the fields do not need to be null
+// terminated
+
+// fallback for the values from_chars rejects as out of range, strtod
+// returns +-inf or a denormal for those
+inline bool
+parseDoubleStrtod(std::string_view field, double& value) noexcept
+{
+   char buffer[64];
+   if (field.empty() || field.size() >= sizeof(buffer))
+      return false;
+
+   std::memcpy(buffer, field.data(), field.size());
+   buffer[field.size()] = '\0';
+
+   char* conv_end;
+   value = std::strtod(buffer, &conv_end);
+
+   return conv_end != buffer;
+}
+
+// returns false if the field does not start with a number, trailing
+// characters are ignored
+inline bool
+parseDouble(std::string_view field, double& value) noexcept
+{
+   const char* begin = field.data();
+   const char* end = begin + field.size();
+
+   // from_chars does not accept an explicit plus sign
+   if (begin != end && *begin == '+')
+   {
+      ++begin;
+      if (begin != end && *begin == '-')
+         return false;
+   }
+
+   auto [ptr, ec] = std::from_chars(begin, end, value);
+
+   if (ec == std::errc::result_out_of_range)
+      return parseDoubleStrtod(field, value);
+
+   return ec == std::errc();
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define SOLFORMAT_HPP
 
 #include "Message.h"
+#include "NumberParser.h"
+#include "core/NameTable.h"
 #include "ska/Hash.hpp"
 
 #include <cassert>
@@ -13,11 +15,16 @@
 struct SOLFormat
 {
    static std::vector<double>
-   read(const std::string& file, const std::vector<std::string>& colNames)
+   read(const std::string& file, const NameTable& colNames)
    {
+      if (colNames.empty())
+         throw std::runtime_error(
+             "unable to read a solution, the problem has no names");
+
       std::vector<double> solution(colNames.size(), 0.0);
 
-      HashMap<std::string, int> nameToId;
+      // the keys are views into the name table
+      HashMap<std::string_view, int> nameToId;
       for (size_t i = 0; i < colNames.size(); ++i)
          nameToId.emplace(colNames[i], i);
 
@@ -53,9 +60,16 @@ struct SOLFormat
             break;
          }
 
+         double value;
+         if (!parseDouble(field2, value))
+         {
+            format_error = true;
+            break;
+         }
+
          auto iter = nameToId.find(field1);
          if (iter != nameToId.end())
-            solution[iter->second] = std::stod(field2);
+            solution[iter->second] = value;
          else
             Message::warn("Skipping unknown variable <{}> in line {}",
                           field1, linenb);
@@ -70,8 +84,14 @@ struct SOLFormat
 
    static void write(const std::string& file,
                      const std::vector<double>& solution,
-                     const std::vector<std::string>& colNames)
+                     const NameTable& colNames)
    {
+      // the columns are permuted when the problem is loaded, only the
+      // names identify them in the original file
+      if (colNames.empty())
+         throw std::runtime_error(
+             "unable to write a solution, the problem has no names");
+
       FILE* out = fopen(file.c_str(), "w");
       if (out == nullptr)
          throw std::runtime_error("unable to open output file");
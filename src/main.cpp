@@ -7,6 +7,7 @@
 
 #include "io/ArgParser.h"
 #include "io/Config.h"
+#include "io/GPHFormat.h"
 #include "io/MPSReader.h"
 #include "io/Message.h"
 #include "io/SOLFormat.h"
@@ -48,14 +49,23 @@ main(int argc, char** argv)
    assert(args.nthreads == -1 || args.nthreads >= 1);
    tbb::task_scheduler_init init(args.nthreads);
 
+   // the names are only needed to read or write solutions and snapshots
+   bool keepNames = args.writeSol || !args.solutionFile.empty() ||
+                    !args.snapshotFile.empty();
+
    // read mip
    auto t0 = Timer::now();
-   MIP mip = MPSReader::parse(args.probFile);
+   MIP mip = args.readSnapshot
+                 ? GPHFormat::read(args.probFile, keepNames)
+                 : MPSReader::parse(args.probFile, keepNames);
    auto t1 = Timer::now();
 
    Message::print("Reading the problem took: {:0.2f} sec.",
                   Timer::seconds(t1, t0));
 
+   if (!args.snapshotFile.empty())
+      GPHFormat::write(args.snapshotFile, mip);
+
    // if the user gave a solution, read it
    std::optional<std::vector<double>> input_sol;
    if (!args.solutionFile.empty())
@@ -74,7 +84,13 @@ main(int argc, char** argv)
        // configuration
        Config(args.configFile));
 
-   std::optional solution = search.run(mip, args.timelimit, input_sol);
+   SearchLimits limits;
+   limits.total = args.timelimit;
+   limits.rootlp = args.lplimit;
+   limits.feasibility = args.feaslimit;
+   limits.improvement = args.imprlimit;
+
+   std::optional solution = search.run(mip, limits, input_sol);
 
    // write the solution to disk
    if (solution && args.writeSol)
@@ -79,7 +79,8 @@ BoundSolution::search(const MIP& mip, const std::vector<double>& lb,
 
                localsolver->changeBounds(lower_bounds[i], upper_bounds[i]);
 
-               auto localresult = localsolver->solve(Algorithm::DUAL);
+               auto localresult =
+                   localsolver->solve(Algorithm::DUAL, tlimit.getToken());
                if (localresult.status == LPResult::OPTIMAL)
                {
                   Message::debug("Bnd: lb: lp feasible");
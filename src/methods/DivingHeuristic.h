@@ -6,12 +6,118 @@
 #include "core/Propagation.h"
 #include "io/Message.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
 static std::string
 operator+(std::string_view str1, std::string_view str2)
 {
    return std::string(str1) + std::string(str2);
 }
 
+// the fractional integer columns that can be fixed, in a heap keyed by the
+// selection's score. Only the columns whose lp value or bounds changed are
+// rescored, outdated heap entries are dropped when they reach the top.
+template <typename SELECTION>
+class DivingCandidates
+{
+ public:
+   void init(const MIP& mip, const std::vector<double>& lb,
+             const std::vector<double>& ub,
+             const std::vector<double>& solution)
+   {
+      auto st = mip.getStats();
+      nints = st.nbin + st.nint;
+
+      version.assign(nints, 0);
+      fractional.assign(nints, false);
+      nfrac = 0;
+      heap.clear();
+
+      for (int col = 0; col < nints; ++col)
+         update(mip, lb, ub, solution, col);
+   }
+
+   void update(const MIP& mip, const std::vector<double>& lb,
+               const std::vector<double>& ub,
+               const std::vector<double>& solution, int col)
+   {
+      if (col >= nints)
+         return;
+
+      ++version[col];
+
+      bool isfrac = !Num::isIntegral(solution[col]) &&
+                    !Num::isFeasEQ(lb[col], ub[col]);
+      nfrac += static_cast<int>(isfrac) - static_cast<int>(fractional[col]);
+      fractional[col] = isfrac;
+
+      // columns without locks in a direction are rounded at the end
+      const auto& downLocks = mip.getDownLocks();
+      const auto& upLocks = mip.getUpLocks();
+      if (!isfrac || std::min(downLocks[col], upLocks[col]) == 0)
+         return;
+
+      auto [score, direction] = SELECTION::score(mip, solution, col);
+      heap.push_back({score, col, direction, version[col]});
+      std::push_heap(heap.begin(), heap.end(), worse);
+
+      if (heap.size() > 2 * static_cast<size_t>(nints))
+         compact();
+   }
+
+   // {column, direction, number of fractional columns}, the column is -1
+   // if there is no candidate
+   std::tuple<int, int, int> select()
+   {
+      while (!heap.empty() &&
+             heap.front().version != version[heap.front().col])
+      {
+         std::pop_heap(heap.begin(), heap.end(), worse);
+         heap.pop_back();
+      }
+
+      if (heap.empty())
+         return {-1, 0, nfrac};
+
+      return {heap.front().col, heap.front().direction, nfrac};
+   }
+
+ private:
+   struct Entry
+   {
+      double score;
+      int col;
+      int direction;
+      int version;
+   };
+
+   // lowest score on top, ties go to the lowest column
+   static bool worse(const Entry& a, const Entry& b)
+   {
+      return std::tie(a.score, a.col) > std::tie(b.score, b.col);
+   }
+
+   void compact()
+   {
+      heap.erase(std::remove_if(heap.begin(), heap.end(),
+                                [this](const Entry& entry) {
+                                   return entry.version !=
+                                          version[entry.col];
+                                }),
+                 heap.end());
+      std::make_heap(heap.begin(), heap.end(), worse);
+   }
+
+   int nints = 0;
+   int nfrac = 0;
+   std::vector<Entry> heap;
+   std::vector<int> version;
+   std::vector<uint8_t> fractional;
+};
+
 template <typename SELECTION>
 class DivingHeuristic : public FeasibilityHeuristic
 {
@@ -60,9 +166,16 @@ class DivingHeuristic : public FeasibilityHeuristic
       std::unique_ptr localsolver = solver->clone();
 
       std::vector<int> changedCols;
-      std::vector<double> oldlbs;
-      std::vector<double> oldubs;
-      std::vector<Activity> old_activities;
+
+      DivingCandidates<SELECTION> candidates;
+      candidates.init(mip, locallb, localub, localsol);
+
+      // what the fixing and its propagation changed, for backtracking
+      PropagationTrail trail;
+      PropagationTrail* fixtrail = propagate && backtrack ? &trail : nullptr;
+
+      // the activities are updated over the whole dive
+      ActivityDrift drift(mip, locallb, localub);
 
       bool hasZeroLockFractionals = false;
       bool limit_reached = false;
@@ -72,8 +185,7 @@ class DivingHeuristic : public FeasibilityHeuristic
       {
          ++iter;
 
-         auto [varToFix, direction, nFrac] =
-             SELECTION::select(mip, locallb, localub, localsol);
+         auto [varToFix, direction, nFrac] = candidates.select();
 
          Message::debug_details("{}: iter {}, nFrac {}", heur_name, iter,
                                 nFrac);
@@ -96,111 +208,153 @@ class DivingHeuristic : public FeasibilityHeuristic
             break;
          }
 
-         // remember the bounds and activities for backtracking
-         if (propagate && backtrack)
-         {
-            oldlbs = locallb;
-            oldubs = localub;
-            old_activities = local_activities;
-         }
+         trail.clear();
 
          double fixedVarOldlb = locallb[varToFix];
          double fixedVarOldub = localub[varToFix];
 
-         if (Num::isMinusInf(locallb[varToFix]) ||
-             Num::isInf(localub[varToFix]))
-         {
-            locallb[varToFix] = Num::floor(localsol[varToFix]);
-            localub[varToFix] = Num::ceil(localsol[varToFix]);
-         }
+         // fixes the variable in a direction and propagates the change
+         auto fix = [&](int col, int dir) -> bool {
+            if (Num::isMinusInf(locallb[col]) || Num::isInf(localub[col]))
+            {
+               locallb[col] = Num::floor(localsol[col]);
+               localub[col] = Num::ceil(localsol[col]);
+            }
 
-         // fix the variable
-         if (direction == 1)
-            locallb[varToFix] = localub[varToFix];
-         else
-         {
-            assert(direction == -1);
-            localub[varToFix] = locallb[varToFix];
-         }
+            if (dir == 1)
+               locallb[col] = localub[col];
+            else
+            {
+               assert(dir == -1);
+               localub[col] = locallb[col];
+            }
+
+            if (!propagate)
+               return true;
 
-         // propagate the change
-         if (propagate)
-         {
             bool status = propagate_get_changed_cols(
-                mip, locallb, localub, local_activities, varToFix,
-                fixedVarOldlb, fixedVarOldub, changedCols);
+                mip, locallb, localub, local_activities, col,
+                fixedVarOldlb, fixedVarOldub, changedCols, fixtrail, {},
+                &drift);
 
             Message::debug_details(
                 "{}: fixed var {} -> {}, propagation: {} changed {}",
-                heur_name, varToFix, locallb[varToFix], status,
-                changedCols.size());
+                heur_name, col, locallb[col], status, changedCols.size());
 
-            if (!status && backtrack)
-            {
-               Message::debug_details("{}: backtraking", heur_name);
+            return status;
+         };
 
-               // backtrack
-               for (int col : changedCols)
-               {
-                  locallb[col] = oldlbs[col];
-                  localub[col] = oldubs[col];
-               }
-               changedCols.clear();
+         // restores the bounds and activities before the fixing
+         auto undo = [&](int col) {
+            trail.undo(locallb, localub, local_activities, &drift);
+            changedCols.clear();
 
-               assert(locallb[varToFix] == oldlbs[varToFix]);
-               assert(localub[varToFix] == oldubs[varToFix]);
+            assert(locallb[col] == fixedVarOldlb);
+            assert(localub[col] == fixedVarOldub);
+         };
 
-               // correct the activities
-               local_activities = old_activities;
+         bool backtracked = false;
 
-               // try the opposite direction
-               if (direction == 1)
-                  localub[varToFix] = locallb[varToFix];
-               else
-                  locallb[varToFix] = localub[varToFix];
+         if (!fix(varToFix, direction))
+         {
+            if (!backtrack)
+            {
+               assert(0);
+               feasible = false;
+               break;
+            }
 
-               status = propagate_get_changed_cols(
-                   mip, locallb, localub, local_activities, varToFix,
-                   fixedVarOldlb, fixedVarOldub, changedCols);
+            Message::debug_details("{}: backtraking", heur_name);
 
-               if (!status)
-               {
-                  feasible = false;
-                  Message::debug_details(
-                      "{}: infeasible after backtracking + propagation",
-                      heur_name);
-                  break;
-               }
-            }
-            else if (!status)
+            // try the opposite direction
+            undo(varToFix);
+            direction = -direction;
+            backtracked = true;
+
+            if (!fix(varToFix, direction))
             {
-               assert(0);
                feasible = false;
+               Message::debug_details(
+                   "{}: infeasible after backtracking + propagation",
+                   heur_name);
                break;
             }
          }
 
          assert(locallb[varToFix] == localub[varToFix]);
 
+         // the lp is rolled back to its bounds and warm basis before the
+         // fixing if it turns out infeasible
+         bool lp_backtrack = propagate && backtrack && !backtracked;
+         if (lp_backtrack)
+            localsolver->checkpoint();
+
          // apply propagation changes and solve
-         for (auto col : changedCols)
-            localsolver->changeBounds(col, locallb[col], localub[col]);
-         changedCols.clear();
+         localsolver->changeBounds(changedCols, locallb, localub);
+
+         auto local_result =
+             localsolver->solve(Algorithm::DUAL, tlimit.getToken());
+
+         if (lp_backtrack && local_result.status == LPResult::INFEASIBLE)
+         {
+            Message::debug_details("{}: LP infeasible, backtracking",
+                                   heur_name);
+
+            localsolver->rollback();
+            undo(varToFix);
+            direction = -direction;
+
+            if (!fix(varToFix, direction))
+            {
+               feasible = false;
+               Message::debug_details(
+                   "{}: infeasible after backtracking + propagation",
+                   heur_name);
+               break;
+            }
+
+            localsolver->changeBounds(changedCols, locallb, localub);
 
-         auto local_result = localsolver->solve(Algorithm::DUAL);
+            local_result =
+                localsolver->solve(Algorithm::DUAL, tlimit.getToken());
+         }
+         else if (lp_backtrack)
+            localsolver->discardCheckpoint();
+
+         candidates.update(mip, locallb, localub, localsol, varToFix);
+         for (int col : changedCols)
+            candidates.update(mip, locallb, localub, localsol, col);
+
+         changedCols.clear();
 
          if (local_result.status != LPResult::OPTIMAL)
          {
-            // TODO backtrack ?
             feasible = false;
             Message::debug_details("{}: LP infeasible", heur_name);
          }
          else
          {
-            localsol = std::move(local_result.primalSol);
+            // the previous lp sol is kept to find the changed values
+            std::swap(localsol, local_result.primalSol);
             localobj = local_result.obj;
 
+            // the objective of the lp only increases while diving
+            if (pool.isCutOff(localobj))
+            {
+               feasible = false;
+               Message::debug_details("{}: cut off by the incumbent",
+                                      heur_name);
+               break;
+            }
+
             roundFeasIntegers(localsol, st.nbin + st.nint);
+
+            const auto& oldsol = local_result.primalSol;
+            for (int col = 0; col < st.nbin + st.nint; ++col)
+            {
+               if (localsol[col] != oldsol[col])
+                  candidates.update(mip, locallb, localub, localsol, col);
+            }
 #ifndef NDEBUG
             bool checklpFeas =
                 checkFeasibility<double, true>(mip, localsol);
@@ -21,14 +21,15 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
    auto st = mip.getStats();
    const auto& objective = mip.getObj();
 
-   std::unique_ptr<LPSolver> localsolver = solver->clone();
-
    if (st.nnzmat >= 1.5e5)
    {
       // TODO : disable propagation in this case
       return;
    }
 
+   std::unique_ptr<LPSolver> localsolver = solver->clone();
+   LPBasis root_basis = localsolver->getBasis();
+
    // the factor in the weight of the old objective in
    // the new objective
    // modified objective:
@@ -46,6 +47,8 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
    std::vector<double> localub(ncols);
    std::vector<double> rounded_sol(ncols);
    std::vector<Activity> local_activities(nrows);
+   ActivityDrift drift(mip, locallb, localub);
+   std::vector<double> pump_obj(ncols);
 
    // the current lp sol
    auto lp_sol = result.primalSol;
@@ -64,9 +67,17 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
    bool limit_reached = false;
    do
    {
+      // no solution can improve on an incumbent as good as the root lp
+      if (pool.isCutOff(result.obj))
+      {
+         Message::debug("FeasPump: cut off by the incumbent");
+         break;
+      }
+
       locallb = lb;
       localub = ub;
       local_activities = activities;
+      drift.clear();
 
       // fix and propagate
       bool propagation_feas = true;
@@ -93,7 +104,7 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
          if (propagation_feas)
             propagation_feas =
                 propagate(mip, locallb, localub, local_activities, col,
-                          oldlb, oldub);
+                          oldlb, oldub, limits, &drift);
       }
 
       // the rounded solution is feasible
@@ -108,14 +119,17 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
 
          if (st.ncont > 0)
          {
-            localsolver.reset();
-            localsolver = solver->clone();
-            for (int col = 0; col < st.nbin + st.nint; ++col)
-            {
-               localsolver->changeBounds(col, sol[col], sol[col]);
-            }
+            // back to the original objective, warm started from the
+            // root basis
+            localsolver->changeObjective(objective);
 
-            auto local_result = localsolver->solve(Algorithm::DUAL);
+            if (!root_basis.empty())
+               localsolver->setBasis(root_basis);
+
+            localsolver->fixColumns(st.nbin + st.nint, sol);
+
+            auto local_result =
+                localsolver->solve(Algorithm::DUAL, tlimit.getToken());
 
             if (local_result.status != LPResult::OPTIMAL)
             {
@@ -186,34 +200,40 @@ FeasPump::search(const MIP& mip, const std::vector<double>& lb,
          if (Num::isFeasEQ(rounded_sol[col], lb[col]))
          {
             ++nlbvar;
-            localsolver->changeObjective(
-                col, 1.0 + alpha * (obj_factor * objective[col] - 1.0));
+            pump_obj[col] =
+                1.0 + alpha * (obj_factor * objective[col] - 1.0);
          }
          else if (Num::isFeasEQ(rounded_sol[col], ub[col]))
          {
             ++nubvar;
-            localsolver->changeObjective(
-                col, -1.0 + alpha * (obj_factor * objective[col] + 1.0));
+            pump_obj[col] =
+                -1.0 + alpha * (obj_factor * objective[col] + 1.0);
          }
          else
-            localsolver->changeObjective(col, obj_factor * alpha *
-                                                  objective[col]);
+            pump_obj[col] = obj_factor * alpha * objective[col];
       }
 
       // set up the current iteration's objective : continuous
       for (int col = st.nbin + st.nint; col < st.ncols; ++col)
-      {
-         localsolver->changeObjective(col,
-                                      obj_factor * alpha * objective[col]);
-      }
+         pump_obj[col] = obj_factor * alpha * objective[col];
+
+      localsolver->changeObjective(pump_obj);
 
       // TODO handle case where all integer variables are not binary
       // and no variable is rounded to its bound
       assert(nlbvar || nubvar);
 
       // solve the lp
-      auto local_result = localsolver->solve(Algorithm::PRIMAL);
-      assert(local_result.status == LPResult::OPTIMAL);
+      auto local_result =
+          localsolver->solve(Algorithm::PRIMAL, tlimit.getToken());
+
+      // the solve was stopped by the time limit
+      if (local_result.status != LPResult::OPTIMAL)
+      {
+         Message::debug("FeasPump: lp not solved, stopping");
+         break;
+      }
+
       assert(!local_result.primalSol.empty());
       lp_sol = std::move(local_result.primalSol);
 
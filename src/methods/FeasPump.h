@@ -2,7 +2,9 @@
 #define FEAS_PUMP_HPP
 #include "core/Heuristic.h"
 #include "core/Numerics.h"
+#include "core/Propagation.h"
 
+#include <stdexcept>
 #include <vector>
 
 class FeasPump : public FeasibilityHeuristic
@@ -16,7 +18,31 @@ class FeasPump : public FeasibilityHeuristic
                const std::vector<int>&, std::shared_ptr<const LPSolver>,
                TimeLimit, SolutionPool&) override;
 
+   void
+   setParam(const std::string& param,
+            const std::variant<std::string, int, double>& value) override
+   {
+      // limits of the propagation of each rounded column
+      if (param == "propagation_maxrows")
+      {
+         limits.maxrows = std::get<int>(value);
+         if (limits.maxrows <= 0)
+            throw std::runtime_error("propagation_maxrows must be positive");
+      }
+      else if (param == "propagation_maxchanges")
+      {
+         limits.maxchanges = std::get<int>(value);
+         if (limits.maxchanges <= 0)
+            throw std::runtime_error(
+                "propagation_maxchanges must be positive");
+      }
+      else
+         Heuristic::setParam(param, value);
+   }
+
  private:
+   PropagationLimits limits;
+
    constexpr static int max_iter = 100;
    constexpr static int max_stall_iter = 70;
    constexpr static int min_flips = 10;
@@ -9,48 +9,19 @@
 
 struct FracDivingSelection
 {
-   static std::tuple<int, int, int>
-   select(const MIP& mip, const std::vector<double>& lb,
-          const std::vector<double>& ub,
-          const std::vector<double>& solution)
+   // prefers the column closest to an integer, rounded to that integer
+   // the direction only depends on the column, a column at 0.9 is rounded
+   // up even if it is the only candidate
+   static std::pair<double, int>
+   score(const MIP&, const std::vector<double>& solution, int col)
    {
-      auto st = mip.getStats();
-      const auto& downLocks = mip.getDownLocks();
-      const auto& upLocks = mip.getUpLocks();
-
-      int varToFix = -1;
-      int direction = 0;
-      double minFrac = std::numeric_limits<double>::max();
-      int nFrac = 0;
-
-      for (int col = 0; col < st.nbin + st.nint; ++col)
-      {
-         if (!Num::isIntegral(solution[col]) &&
-             !Num::isFeasEQ(lb[col], ub[col]))
-         {
-            ++nFrac;
-            if (std::min(downLocks[col], upLocks[col]) == 0)
-               continue;
-
-            const double fractionality =
-                solution[col] - Num::floor(solution[col]);
-
-            if (fractionality < minFrac)
-            {
-               varToFix = col;
-               minFrac = fractionality;
-               direction = -1;
-            }
-            else if (1.0 - fractionality < minFrac)
-            {
-               varToFix = col;
-               minFrac = 1.0 - fractionality;
-               direction = 1;
-            }
-         }
-      }
-
-      return {varToFix, direction, nFrac};
+      const double fractionality =
+          solution[col] - Num::floor(solution[col]);
+
+      if (fractionality <= 0.5)
+         return {fractionality, -1};
+
+      return {1.0 - fractionality, 1};
    }
 
    static constexpr std::string_view name = "Frac";
@@ -384,13 +384,13 @@ IntShifting::search(const MIP& mip, const std::vector<double>& lb,
          if (!localsolver)
             localsolver = lpsolver->clone();
 
-         for (int col = 0; col < st.nbin + st.nint; ++col)
-         {
-            assert(Num::isIntegral(solution[col]));
-            localsolver->changeBounds(col, solution[col], solution[col]);
-         }
+         assert(std::all_of(
+             solution.begin(), solution.begin() + st.nbin + st.nint,
+             [](double val) { return Num::isIntegral(val); }));
+         localsolver->fixColumns(st.nbin + st.nint, solution);
 
-         auto local_result = localsolver->solve(Algorithm::DUAL);
+         auto local_result =
+             localsolver->solve(Algorithm::DUAL, tlimit.getToken());
          if (local_result.status == LPResult::OPTIMAL)
          {
             Message::debug("ShifInt: lp sol feasible");
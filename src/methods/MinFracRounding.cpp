@@ -38,10 +38,9 @@ MinFracRounding::search(const MIP& mip, const std::vector<double>& lb,
          Message::debug("FracRound: feasible, solving lp");
          localsolver = solver->clone();
 
-         for (int col = 0; col < st.nbin + st.nint; ++col)
-            localsolver->changeBounds(col, sol[col], sol[col]);
+         localsolver->fixColumns(st.nbin + st.nint, sol);
 
-         auto res = localsolver->solve(Algorithm::DUAL);
+         auto res = localsolver->solve(Algorithm::DUAL, tlimit.getToken());
 
          // ??
          if (res.status == LPResult::OPTIMAL)
@@ -8,7 +8,7 @@ Octane::search(const MIP& mip, const std::vector<double>& lb,
                const std::vector<double>& ub, const std::vector<Activity>&,
                const LPResult& result, const std::vector<double>&,
                const std::vector<int>&, std::shared_ptr<const LPSolver>,
-               TimeLimit, SolutionPool& pool)
+               TimeLimit tlimit, SolutionPool& pool)
 
 {
    int ncols = mip.getNCols();
@@ -208,9 +208,14 @@ Octane::search(const MIP& mip, const std::vector<double>& lb,
    Message::debug_details("Octane: generated {} facets",
                           k_closest_facets.size());
 
+   if (tlimit.reached(Timer::now()))
+      return;
+
    // check feasibility of the solutions corresponding to the facets
    for (auto& [facet, ln, ld, id] : k_closest_facets)
    {
+      if (tlimit.reached(Timer::now()))
+         return;
 
 #ifndef NDEBUG
       std::vector<double> solution(ncols);
@@ -40,15 +40,18 @@ RandRounding::search(const MIP& mip, const std::vector<double>& lb,
       else
       {
          Message::debug("RandRound: feasible, solving lp");
-         if (localsolver)
-            localsolver.release();
 
-         localsolver = solver->clone();
+         // the copy is rolled back to the bounds and basis of the root lp
+         // for the next rounding
+         if (!localsolver)
+            localsolver = solver->clone();
 
-         for (int col = 0; col < st.nbin + st.nint; ++col)
-            localsolver->changeBounds(col, sol[col], sol[col]);
+         localsolver->checkpoint();
 
-         auto res = localsolver->solve(Algorithm::DUAL);
+         localsolver->fixColumns(st.nbin + st.nint, sol);
+
+         auto res = localsolver->solve(Algorithm::DUAL, tlimit.getToken());
+         localsolver->rollback();
 
          // ??
          if (res.status == LPResult::OPTIMAL)
@@ -105,6 +108,13 @@ RandRounding::search(const MIP& mip, const std::vector<double>& lb,
       ++iter;
       Message::debug("RandRound: iter {}", iter);
 
+      // no solution can improve on an incumbent as good as the root lp
+      if (pool.isCutOff(result.obj))
+      {
+         Message::debug("RandRound: cut off by the incumbent");
+         break;
+      }
+
       locallb = locallb_partial;
       localub = localub_partial;
       local_activities = local_activities_partial;
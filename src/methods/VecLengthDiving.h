@@ -9,60 +9,21 @@
 
 struct VecLenDivingSelection
 {
-   static std::tuple<int, int, int>
-   select(const MIP& mip, const std::vector<double>& lb,
-          const std::vector<double>& ub,
-          const std::vector<double>& solution)
+   // prefers the objective change per row of the column, rounded in the
+   // direction that deteriorates the objective
+   static std::pair<double, int>
+   score(const MIP& mip, const std::vector<double>& solution, int col)
    {
-      const auto& downLocks = mip.getDownLocks();
-      const auto& upLocks = mip.getUpLocks();
       const auto& objective = mip.getObj();
-      auto st = mip.getStats();
 
-      int varToFix = -1;
-      int direction = 0;
-      double minVecLengthRatio = std::numeric_limits<double>::max();
-      int nFrac = 0;
+      const double fractionality =
+          solution[col] - Num::floor(solution[col]);
+      int length = mip.getColSize(col);
 
-      for (int col = 0; col < st.nbin + st.nint; ++col)
-      {
-         if (!Num::isIntegral(solution[col]) &&
-             !Num::isFeasEQ(lb[col], ub[col]))
-         {
-            ++nFrac;
-            if (std::min(downLocks[col], upLocks[col]) == 0)
-               continue;
+      if (objective[col] >= 0)
+         return {objective[col] * (1.0 - fractionality) / (1 + length), 1};
 
-            const double fractionality =
-                solution[col] - Num::floor(solution[col]);
-            int length = mip.getColSize(col);
-
-            if (objective[col] >= 0)
-            {
-               double colRatio =
-                   objective[col] * (1.0 - fractionality) / (1 + length);
-               if (colRatio < minVecLengthRatio)
-               {
-                  minVecLengthRatio = colRatio;
-                  varToFix = col;
-                  direction = +1;
-               }
-            }
-            else
-            {
-               double colRatio =
-                   objective[col] * fractionality / (1 + length);
-               if (colRatio < minVecLengthRatio)
-               {
-                  minVecLengthRatio = colRatio;
-                  varToFix = col;
-                  direction = -1;
-               }
-            }
-         }
-      }
-
-      return {varToFix, direction, nFrac};
+      return {objective[col] * fractionality / (1 + length), -1};
    }
 
    static constexpr std::string_view name{"VecLen"};
@@ -0,0 +1,85 @@
+#include "catch2/catch.hpp"
+#include "io/MPSReader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+static std::string
+instance(const std::string& name)
+{
+   return std::string(GPH_TEST_INSTANCES) + "/" + name;
+}
+
+// writes an instance large enough for the COLUMNS section to be parsed in
+// several chunks, the columns of the first chunk only have an objective
+// coefficient
+static std::string
+writeChunkedInstance(const std::string& name, bool onefield)
+{
+   const int nobjonly = 100;
+   const int ncols = 120;
+
+   std::string path =
+       (std::filesystem::temp_directory_path() / name).string();
+   std::ofstream out(path);
+
+   out << "NAME          CHUNKED\n"
+       << "ROWS\n"
+       << " N  obj\n"
+       << " L  c1\n"
+       << "COLUMNS\n";
+   for (int col = 0; col < ncols; ++col)
+   {
+      if (onefield && col == ncols / 2)
+         out << "    malformed\n";
+
+      out << "    x" << col << "        obj       1.0";
+      if (col >= nobjonly)
+         out << "        c1        1.0";
+      out << "\n";
+   }
+   out << "RHS\n"
+       << "    rhs       c1        1.0\n"
+       << "BOUNDS\n"
+       << "ENDATA\n";
+
+   return path;
+}
+
+TEST_CASE("objective only columns at the start of a chunked section",
+          "[mps]")
+{
+   std::string path = writeChunkedInstance("objonly.mps", false);
+   MIP mip = MPSReader::parse(path);
+   std::filesystem::remove(path);
+
+   const auto& obj = mip.getObj();
+   REQUIRE(mip.getNCols() == 120);
+   REQUIRE(obj.size() == 120);
+   REQUIRE(std::accumulate(obj.begin(), obj.end(), 0.0) == 120.0);
+}
+
+TEST_CASE("one field line in the middle of a chunked section", "[mps]")
+{
+   std::string path = writeChunkedInstance("onefield.mps", true);
+   REQUIRE_THROWS(MPSReader::parse(path));
+   std::filesystem::remove(path);
+}
+
+#ifdef ZLIB_FOUND
+
+// the last line has neither a newline nor ENDATA
+TEST_CASE("gzip input ending without ENDATA is a format error", "[mps]")
+{
+   REQUIRE_THROWS(MPSReader::parse(instance("no_endata.mps.gz")));
+}
+
+// the compressed stream stops in the middle of the file
+TEST_CASE("truncated gzip input is an error", "[mps]")
+{
+   REQUIRE_THROWS(MPSReader::parse(instance("truncated.mps.gz")));
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "catch2/catch.hpp"
+#include "core/Common.h"
+#include "core/Propagation.h"
+
+#include <vector>
+
+// x0 + x1 <= 10, x2 - x1 <= 0, x3 - x2 <= 0 with integer x in [0, 10],
+// fixing x0 to 10 tightens the upper bounds of x1, x2 and x3 one row
+// after the other
+static MIP
+chainMip()
+{
+   const double inf = Num::infinity();
+
+   std::vector<double> coefsT{1.0, 1.0, -1.0, 1.0, -1.0, 1.0};
+   std::vector<int> idxT{0, 0, 1, 1, 2, 2};
+   std::vector<int> rstartT{0, 1, 3, 5, 6};
+
+   std::vector<double> rhs{10.0, 0.0, 0.0};
+   std::vector<double> lhs{-inf, -inf, -inf};
+   std::vector<double> lbs(4, 0.0);
+   std::vector<double> ubs(4, 10.0);
+   std::vector<double> obj(4, 1.0);
+   dynamic_bitset<> integer(4);
+   integer.set();
+
+   return MIP(std::move(coefsT), std::move(idxT), std::move(rstartT),
+              std::move(rhs), std::move(lhs), std::move(lbs),
+              std::move(ubs), std::move(obj), integer, 3, NameTable(),
+              NameTable());
+}
+
+static void
+fixFirstColumn(const MIP& mip, std::vector<double>& lb,
+               std::vector<double>& ub, std::vector<Activity>& activities,
+               const PropagationLimits& limits, ActivityDrift* drift)
+{
+   lb[0] = 10.0;
+   REQUIRE(propagate(mip, lb, ub, activities, 0, 0.0, 10.0, limits, drift));
+}
+
+TEST_CASE("propagation stopped at a limit keeps valid bounds",
+          "[propagation]")
+{
+   MIP mip = chainMip();
+
+   auto fulllb = mip.getLB();
+   auto fullub = mip.getUB();
+   auto fullactivities = computeActivities(mip);
+   fixFirstColumn(mip, fulllb, fullub, fullactivities, {}, nullptr);
+   REQUIRE(fullub == std::vector<double>{10.0, 0.0, 0.0, 0.0});
+
+   PropagationLimits limits;
+   SECTION("row limit") { limits.maxrows = 1; }
+   SECTION("change limit") { limits.maxchanges = 2; }
+
+   for (bool withdrift : {false, true})
+   {
+      auto lb = mip.getLB();
+      auto ub = mip.getUB();
+      auto activities = computeActivities(mip);
+      ActivityDrift drift(mip, lb, ub);
+      fixFirstColumn(mip, lb, ub, activities, limits,
+                     withdrift ? &drift : nullptr);
+
+      // only the first row was propagated
+      REQUIRE(ub == std::vector<double>{10.0, 0.0, 10.0, 10.0});
+
+      // the bounds lie between the original and the fully propagated ones
+      for (int col = 0; col < mip.getNCols(); ++col)
+      {
+         REQUIRE(lb[col] >= mip.getLB()[col]);
+         REQUIRE(ub[col] <= mip.getUB()[col]);
+         REQUIRE(lb[col] <= fulllb[col]);
+         REQUIRE(ub[col] >= fullub[col]);
+      }
+
+      // the activities match the bounds
+      for (int row = 0; row < mip.getNRows(); ++row)
+      {
+         Activity activity = computeActivity(mip, row, lb, ub);
+         REQUIRE(activities[row].min == Approx(activity.min));
+         REQUIRE(activities[row].max == Approx(activity.max));
+         REQUIRE(activities[row].ninfmin == activity.ninfmin);
+         REQUIRE(activities[row].ninfmax == activity.ninfmax);
+      }
+   }
+}